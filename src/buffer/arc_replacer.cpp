@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ArcReplacer::ArcReplacer(size_t num_frames)
+    : num_frames_(num_frames),
+      list_of_(num_frames, ListId::None),
+      position_(num_frames),
+      is_evictable_(num_frames, false),
+      page_of_(num_frames, INVALID_PAGE_ID),
+      is_ghost_hit_(num_frames, false) {}
+
+auto ArcReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (num_evictable_[static_cast<size_t>(ListId::T1)] + num_evictable_[static_cast<size_t>(ListId::T2)] == 0) {
+    return false;
+  }
+
+  auto &list = ShouldEvictFromT1() ? t1_ : t2_;
+  auto it = std::find_if(list.begin(), list.end(), [this](frame_id_t fid) { return is_evictable_[fid]; });
+  *frame_id = *it;
+  Untrack(*frame_id, true);
+  TrimGhosts();
+  return true;
+}
+
+void ArcReplacer::RecordLoad(frame_id_t frame_id, page_id_t page_id) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+  page_of_[frame_id] = page_id;
+  is_ghost_hit_[frame_id] = false;
+
+  // A ghost hit in B1 means T1 was too small to keep the page until its second access, one in B2 that T2 was.
+  if (auto it = b1_index_.find(page_id); it != b1_index_.end()) {
+    target_t1_ = std::min(num_frames_, target_t1_ + std::max<size_t>(b2_.size() / b1_.size(), 1));
+    b1_.erase(it->second);
+    b1_index_.erase(it);
+    is_ghost_hit_[frame_id] = true;
+  } else if (auto it = b2_index_.find(page_id); it != b2_index_.end()) {
+    auto delta = std::max<size_t>(b1_.size() / b2_.size(), 1);
+    target_t1_ = target_t1_ > delta ? target_t1_ - delta : 0;
+    b2_.erase(it->second);
+    b2_index_.erase(it);
+    is_ghost_hit_[frame_id] = true;
+  }
+}
+
+void ArcReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  auto current = list_of_[frame_id];
+  if (current == ListId::None) {
+    auto target = is_ghost_hit_[frame_id] ? ListId::T2 : ListId::T1;
+    is_ghost_hit_[frame_id] = false;
+    auto &list = ResidentList(target);
+    position_[frame_id] = list.insert(list.end(), frame_id);
+    list_of_[frame_id] = target;
+    TrimGhosts();
+    return;
+  }
+  if (access_type == AccessType::Scan) {
+    return;
+  }
+
+  // Any further access makes the frame the most recently used one of T2.
+  t2_.splice(t2_.end(), ResidentList(current), position_[frame_id]);
+  if (is_evictable_[frame_id]) {
+    num_evictable_[static_cast<size_t>(current)]--;
+    num_evictable_[static_cast<size_t>(ListId::T2)]++;
+  }
+  list_of_[frame_id] = ListId::T2;
+}
+
+void ArcReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  auto list = list_of_[frame_id];
+  if (list == ListId::None || is_evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  is_evictable_[frame_id] = set_evictable;
+  if (set_evictable) {
+    num_evictable_[static_cast<size_t>(list)]++;
+  } else {
+    num_evictable_[static_cast<size_t>(list)]--;
+  }
+}
+
+void ArcReplacer::Remove(frame_id_t frame_id) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (list_of_[frame_id] == ListId::None) {
+    return;
+  }
+  BUSTUB_ENSURE(is_evictable_[frame_id], "Remove is called on a non-evictable frame");
+  Untrack(frame_id, false);
+}
+
+auto ArcReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // Assume that the list chosen for the next eviction keeps being chosen until it runs out of evictable frames.
+  bool t1_first = ShouldEvictFromT1();
+  for (auto *list : {t1_first ? &t1_ : &t2_, t1_first ? &t2_ : &t1_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; ++it) {
+      if (is_evictable_[*it]) {
+        candidates.push_back(*it);
+      }
+    }
+  }
+  return candidates;
+}
+
+auto ArcReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> lock(latch_);
+  return num_evictable_[static_cast<size_t>(ListId::T1)] + num_evictable_[static_cast<size_t>(ListId::T2)];
+}
+
+void ArcReplacer::Untrack(frame_id_t frame_id, bool remember) {
+  auto list = list_of_[frame_id];
+  ResidentList(list).erase(position_[frame_id]);
+  if (is_evictable_[frame_id]) {
+    num_evictable_[static_cast<size_t>(list)]--;
+  }
+
+  auto page_id = page_of_[frame_id];
+  if (remember && page_id != INVALID_PAGE_ID) {
+    auto &ghosts = list == ListId::T1 ? b1_ : b2_;
+    auto &index = list == ListId::T1 ? b1_index_ : b2_index_;
+    if (auto it = index.find(page_id); it != index.end()) {
+      ghosts.erase(it->second);
+    }
+    index[page_id] = ghosts.insert(ghosts.end(), page_id);
+  }
+
+  list_of_[frame_id] = ListId::None;
+  is_evictable_[frame_id] = false;
+  page_of_[frame_id] = INVALID_PAGE_ID;
+}
+
+void ArcReplacer::TrimGhosts() {
+  while (!b1_.empty() && t1_.size() + b1_.size() > num_frames_) {
+    b1_index_.erase(b1_.front());
+    b1_.pop_front();
+  }
+  while (!b2_.empty() && t1_.size() + t2_.size() + b1_.size() + b2_.size() > 2 * num_frames_) {
+    b2_index_.erase(b2_.front());
+    b2_.pop_front();
+  }
+}
+
+auto ArcReplacer::ShouldEvictFromT1() const -> bool {
+  auto t1_evictable = num_evictable_[static_cast<size_t>(ListId::T1)];
+  auto t2_evictable = num_evictable_[static_cast<size_t>(ListId::T2)];
+  return t1_evictable > 0 && (t1_.size() > target_t1_ || t2_evictable == 0);
+}
+
+}  // namespace bustub
@@ -12,164 +12,1181 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <new>
+#include <unordered_map>
+
 #include "common/exception.h"
 #include "common/macros.h"
+#include "fmt/format.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+                                     LogManager *log_manager, size_t num_shards, ReplacerPolicy replacer_policy,
+                                     bool use_huge_pages, size_t max_pool_size, size_t compressed_cache_size)
+    : pool_size_(pool_size),
+      max_pool_size_(std::max(pool_size, max_pool_size)),
+      replacer_k_(replacer_k),
+      replacer_policy_(replacer_policy),
+      frame_arena_(std::make_unique<FrameArena>(max_pool_size_, use_huge_pages)),
+      disk_manager_(disk_manager),
+      disk_scheduler_(std::make_unique<DiskScheduler>(disk_manager)),
+      log_manager_(log_manager) {
+  BUSTUB_ENSURE(num_shards > 0 && num_shards <= pool_size, "invalid number of buffer pool shards");
+  if (compressed_cache_size > 0) {
+    compressed_cache_ = std::make_unique<CompressedPageCache>(compressed_cache_size, disk_scheduler_.get());
+  }
+
+  // we allocate a consecutive memory space for the buffer pool, the pages only hold the metadata of the frames
+  pages_ = static_cast<Page *>(::operator new[](max_pool_size_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    new (&pages_[i]) Page(frame_arena_->FrameData(i));
+  }
+
+  // Split the frames into contiguous ranges, the first `pool_size % num_shards` shards get one extra frame. Each shard
+  // uses the start of its range, and grows into the rest of it.
+  frame_id_t frame_offset = 0;
+  for (size_t i = 0; i < num_shards; ++i) {
+    size_t num_frames = ShardShare(pool_size, num_shards, i);
+    size_t max_frames = ShardShare(max_pool_size_, num_shards, i);
+    auto shard = std::make_unique<Shard>(i, frame_offset, num_frames, max_frames, replacer_policy, replacer_k);
+    // Initially, every page is in the free list.
+    for (size_t j = 0; j < num_frames; ++j) {
+      shard->free_list_.emplace_back(frame_offset + static_cast<frame_id_t>(j));
+    }
+    frame_offset += static_cast<frame_id_t>(max_frames);
+    shards_.emplace_back(std::move(shard));
+  }
+}
 
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+BufferPoolManager::~BufferPoolManager() {
+  warm_up_stop_ = true;
+  WaitForWarmUp();
+  StopBackgroundWriter();
+  {
+    std::scoped_lock lock(read_ahead_latch_);
+    read_ahead_stop_ = true;
   }
+  read_ahead_cv_.notify_all();
+  if (read_ahead_thread_.joinable()) {
+    read_ahead_thread_.join();
+  }
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_, std::align_val_t{alignof(Page)});
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+void BufferPoolManager::SetReplacerPolicy(ReplacerPolicy replacer_policy) {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->latch_);
+    auto replacer = MakeReplacer(replacer_policy, shard->max_frames_, replacer_k_);
+    shard->page_table_.ForEach([&replacer, &shard](page_id_t page_id, frame_id_t frame_id) {
+      replacer->RecordLoad(frame_id - shard->frame_offset_, page_id);
+      replacer->RecordAccess(frame_id - shard->frame_offset_, AccessType::Unknown);
+      replacer->SetEvictable(frame_id - shard->frame_offset_, true);
+    });
+    shard->replacer_ = std::move(replacer);
+  }
+  replacer_policy_ = replacer_policy;
+}
 
 auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  std::lock_guard<std::mutex> lock(latch_);
-  auto page = GetAvailablePage(AllocatePage(), AccessType::Unknown);
-  if (page != nullptr) {
-    *page_id = page->page_id_;
+  size_t start = next_new_shard_++;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto &shard = *shards_[(start + i) % shards_.size()];
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    if (shard.free_list_.empty() && shard.replacer_->Size() == 0) {
+      continue;
+    }
+    auto new_page_id = AllocatePage(shard);
+    // The id may have been freed while a reader still had it loaded, that copy of the old page must go first.
+    frame_id_t stale_frame_id;
+    if (shard.page_table_.Find(new_page_id, &stale_frame_id) && !FreeFrame(shard, stale_frame_id)) {
+      DeallocatePage(new_page_id);
+      continue;
+    }
+    auto page = GetAvailablePage(shard, lock, new_page_id, AccessType::Unknown, false);
+    if (page != nullptr) {
+      *page_id = new_page_id;
+      return page;
+    }
+    DeallocatePage(new_page_id);
   }
-  return page;
+  return nullptr;
+}
+
+auto BufferPoolManager::SchedulePageIO(bool is_write, page_id_t page_id, char *data) -> std::future<bool> {
+  auto promise = disk_scheduler_->CreatePromise();
+  auto future = promise.get_future();
+  disk_scheduler_->Schedule({is_write, data, page_id, std::move(promise)});
+  return future;
 }
 
-auto BufferPoolManager::GetAvailablePage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
+auto BufferPoolManager::GetAvailablePage(Shard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id,
+                                         AccessType access_type, bool read_page, bool defer_read) -> Page * {
   frame_id_t frame_id;
-  Page *page;
-  if (!free_list_.empty()) { /* page from the free_list_ */
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-    page = &pages_[frame_id];
-  } else { /* evicted page */
-    if (!replacer_->Evict(&frame_id)) {
+  Page *page = nullptr;
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  bool victim_dirty = false;
+  for (auto it = shard.free_list_.begin(); it != shard.free_list_.end(); ++it) { /* page from the free_list_ */
+    // A fetcher that found the frame's previous page may still hold a pin for a moment, and may need the latch to
+    // drop it, so such a frame is left for later.
+    int pin_count = 0;
+    if (pages_[*it].pin_count_.compare_exchange_strong(pin_count, -1)) {
+      frame_id = *it;
+      page = &pages_[frame_id];
+      shard.free_list_.erase(it);
+      break;
+    }
+  }
+  if (page == nullptr) { /* evicted page */
+    DrainAccesses(shard);
+    // Hits pin frames without telling the replacer, a victim is only taken once its pin count went from 0 to -1.
+    // Frames found pinned are set aside and tracked again afterwards as if they had just been accessed, so that the
+    // replacer does not hand out the same pinned frame twice.
+    std::vector<frame_id_t> pinned_frames;
+    bool found = false;
+    while (shard.replacer_->Evict(&frame_id)) {
+      page = &pages_[frame_id + shard.frame_offset_];
+      int pin_count = 0;
+      if (page->pin_count_.compare_exchange_strong(pin_count, -1)) {
+        found = true;
+        break;
+      }
+      pinned_frames.push_back(frame_id);
+    }
+    replacer_pinned_victims_.Add(pinned_frames.size());
+    for (auto pinned_frame_id : pinned_frames) {
+      shard.replacer_->RecordLoad(pinned_frame_id, pages_[pinned_frame_id + shard.frame_offset_].page_id_);
+      shard.replacer_->RecordAccess(pinned_frame_id, AccessType::Unknown);
+      shard.replacer_->SetEvictable(pinned_frame_id, true);
+    }
+    if (!found) {
       return nullptr;
     }
 
-    page = &pages_[frame_id];
-    if (page->is_dirty_) {
-      disk_manager_->WritePage(page->page_id_, page->GetData());
-      page->is_dirty_ = false;
+    frame_id += shard.frame_offset_;
+    victim_page_id = page->page_id_;
+    victim_dirty = page->is_dirty_;
+    page->is_dirty_ = false;
+    if (victim_dirty) {
+      dirty_evictions_++;
+    } else {
+      clean_evictions_++;
+    }
+    shard.page_table_.Erase(victim_page_id);
+    // Fetchers of the victim wait until it is on disk, or in the compressed cache which takes clean victims too.
+    if (victim_dirty || compressed_cache_ != nullptr) {
+      shard.writeback_pages_.insert(victim_page_id);
     }
-
-    page->ResetMemory();
-    page_table_.erase(page->page_id_);
   }
-  // Initializing new page
-  page_table_[page_id] = frame_id;
-  page->pin_count_ = 1;
+  // Initializing new page. Until the I/O below is done, fetchers of page_id pin the frame and wait for it. The frame
+  // is set up before it is published in the page table, where hits may find it right away.
   page->page_id_ = page_id;
-  replacer_->RecordAccess(frame_id, access_type);
+  page->is_io_pending_ = victim_page_id != INVALID_PAGE_ID || read_page || defer_read;
+  page->pin_count_ = 1;
+  shard.page_table_.Insert(page_id, frame_id);
+  shard.replacer_->RecordLoad(frame_id - shard.frame_offset_, page_id);
+  shard.replacer_->RecordAccess(frame_id - shard.frame_offset_, access_type);
+  shard.replacer_->SetEvictable(frame_id - shard.frame_offset_, true);
+  if (victim_page_id == INVALID_PAGE_ID && !read_page) {
+    return page;
+  }
+
+  lock.unlock();
+  bool written = true;
+  if (victim_page_id != INVALID_PAGE_ID) {
+    bool cached = compressed_cache_ != nullptr && compressed_cache_->Put(victim_page_id, page->GetData(), victim_dirty);
+    if (victim_dirty && !cached) {
+      written = SchedulePageIO(true, victim_page_id, page->GetData()).get();
+    }
+    if (written) {
+      page->ResetMemory();
+    }
+  }
+  bool read = true;
+  if (written && read_page && !ReadFromCompressedCache(page)) {
+    read = SchedulePageIO(false, page_id, page->GetData()).get();
+  }
+  lock.lock();
+
+  if (!written) {
+    // The victim stays in the frame, still dirty, and page_id is given up on. Its fetchers find the frame taken back.
+    dirty_evictions_--;
+    shard.page_table_.Erase(page_id);
+    page->page_id_ = victim_page_id;
+    page->is_dirty_ = true;
+    shard.page_table_.Insert(victim_page_id, frame_id);
+    shard.replacer_->RecordLoad(frame_id - shard.frame_offset_, victim_page_id);
+    shard.writeback_pages_.erase(victim_page_id);
+    page->is_io_pending_ = false;
+    page->pin_count_--;
+    shard.io_cv_.notify_all();
+    return nullptr;
+  }
+  if (!read) {
+    if (victim_dirty || compressed_cache_ != nullptr) {
+      shard.writeback_pages_.erase(victim_page_id);
+    }
+    DropUnreadFrame(shard, page, true);
+    return nullptr;
+  }
+  page->is_io_pending_ = defer_read;
+  if (victim_dirty || compressed_cache_ != nullptr) {
+    shard.writeback_pages_.erase(victim_page_id);
+  }
+  shard.io_cv_.notify_all();
   return page;
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  std::lock_guard<std::mutex> lock(latch_);
+auto BufferPoolManager::ReadFromCompressedCache(Page *page) -> bool {
+  bool is_dirty;
+  if (compressed_cache_ == nullptr || !compressed_cache_->Get(page->page_id_, page->GetData(), &is_dirty)) {
+    return false;
+  }
+  page->is_dirty_ = is_dirty;
+  return true;
+}
+
+void BufferPoolManager::DropUnreadFrame(Shard &shard, Page *page, bool unpin) {
+  auto frame_id = static_cast<frame_id_t>(page - pages_);
+  shard.replacer_->Remove(frame_id - shard.frame_offset_);
+  shard.page_table_.Erase(page->page_id_);
+  page->ResetMemory();
+  page->is_dirty_ = false;
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_io_pending_ = false;
+  if (unpin) {
+    page->pin_count_--;
+  }
+  // Fetchers still holding a pin release it once they see the frame lost its page, the frame is not taken until then.
+  shard.free_list_.emplace_back(frame_id);
+  shard.io_cv_.notify_all();
+}
+
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
   if (page_id == INVALID_PAGE_ID) {
     return nullptr;
   }
+  auto &shard = ShardOf(page_id);
+  auto page = TryPinResident(shard, page_id);
+  if (page != nullptr) {
+    shard.hits_[static_cast<size_t>(access_type)].Add();
+    RecordHit(shard, page_id, access_type);
+  } else {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    // The page may have just been evicted dirty; reading it before the write-back lands would see stale data.
+    if (shard.writeback_pages_.count(page_id) != 0) {
+      auto wait_start = std::chrono::steady_clock::now();
+      shard.io_cv_.wait(lock, [&shard, page_id] { return shard.writeback_pages_.count(page_id) == 0; });
+      pin_wait_latency_.RecordSince(wait_start);
+    }
 
-  Page *page;
-  if (page_table_.count(page_id) != 0) {
-    auto frame_id = page_table_[page_id];
-    replacer_->RecordAccess(frame_id);
-    replacer_->SetEvictable(frame_id, false);
+    frame_id_t frame_id;
+    if (!shard.page_table_.Find(page_id, &frame_id)) {
+      // A freed page must not get a frame, NewPage() would map its id a second time once it hands the id out again.
+      if (!disk_manager_->IsAllocated(page_id)) {
+        return nullptr;
+      }
+      shard.misses_[static_cast<size_t>(access_type)].Add();
+      page = GetAvailablePage(shard, lock, page_id, access_type, true);
+      miss_latency_.RecordSince(start);
+      return page;
+    }
+    shard.hits_[static_cast<size_t>(access_type)].Add();
+    shard.replacer_->RecordAccess(frame_id - shard.frame_offset_, access_type);
     page = &pages_[frame_id];
+    // Frames are only taken for another page with the latch held, the pin count can't be -1 here.
     page->pin_count_++;
-  } else {
-    page = GetAvailablePage(page_id, access_type);
-    if (page != nullptr) {
-      disk_manager_->ReadPage(page_id, page->GetData());
+  }
+
+  if (page->is_io_pending_) {
+    // Another thread is still loading this page into the frame, wait for it instead of blocking the whole pool.
+    auto wait_start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    shard.io_cv_.wait(lock, [page] { return !page->is_io_pending_; });
+    pin_wait_latency_.RecordSince(wait_start);
+  }
+  // The read of the page failed, and the frame was given up.
+  if (page->page_id_ != page_id) {
+    UnpinFrame(page, false);
+    return nullptr;
+  }
+  // The first fetch of a page read ahead takes over the pin of the read-ahead.
+  if (page->is_prefetched_.exchange(false)) {
+    page->pin_count_--;
+  }
+  return page;
+}
+
+auto BufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  // Pin the resident pages without any latch, and group the others by shard.
+  std::vector<std::vector<size_t>> shard_misses(shards_.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    auto page_id = page_ids[i];
+    if (page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto &shard = ShardOf(page_id);
+    pages[i] = TryPinResident(shard, page_id);
+    if (pages[i] != nullptr) {
+      shard.hits_[static_cast<size_t>(access_type)].Add();
+      RecordHit(shard, page_id, access_type);
+    } else {
+      shard_misses[static_cast<size_t>(page_id) % shards_.size()].push_back(i);
+    }
+  }
+
+  // Reserve a frame for every miss with the shard latch taken once, the reads are scheduled all together afterwards.
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Page *> loading;
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (size_t shard_index = 0; shard_index < shards_.size(); ++shard_index) {
+    if (shard_misses[shard_index].empty()) {
+      continue;
+    }
+    auto &shard = *shards_[shard_index];
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    for (auto i : shard_misses[shard_index]) {
+      auto page_id = page_ids[i];
+      if (shard.writeback_pages_.count(page_id) != 0) {
+        auto wait_start = std::chrono::steady_clock::now();
+        shard.io_cv_.wait(lock, [&shard, page_id] { return shard.writeback_pages_.count(page_id) == 0; });
+        pin_wait_latency_.RecordSince(wait_start);
+      }
+
+      frame_id_t frame_id;
+      if (shard.page_table_.Find(page_id, &frame_id)) {
+        // Resident by now, or a duplicate of a page this batch is loading.
+        shard.hits_[static_cast<size_t>(access_type)].Add();
+        shard.replacer_->RecordAccess(frame_id - shard.frame_offset_, access_type);
+        pages[i] = &pages_[frame_id];
+        pages[i]->pin_count_++;
+        continue;
+      }
+      if (!disk_manager_->IsAllocated(page_id)) {
+        continue;
+      }
+      shard.misses_[static_cast<size_t>(access_type)].Add();
+      auto page = GetAvailablePage(shard, lock, page_id, access_type, false, true);
+      if (page == nullptr) {
+        continue;
+      }
+      pages[i] = page;
+      if (ReadFromCompressedCache(page)) {
+        page->is_io_pending_ = false;
+        shard.io_cv_.notify_all();
+        miss_latency_.RecordSince(start);
+        continue;
+      }
+      loading.push_back(page);
+      auto promise = disk_scheduler_->CreatePromise();
+      futures.push_back(promise.get_future());
+      requests.push_back({false, page->GetData(), page_id, std::move(promise)});
+    }
+  }
+
+  if (!requests.empty()) {
+    disk_scheduler_->Schedule(std::move(requests));
+    for (size_t i = 0; i < loading.size(); ++i) {
+      bool read = futures[i].get();
+      miss_latency_.RecordSince(start);
+      auto page = loading[i];
+      auto &shard = ShardOf(page->page_id_);
+      std::scoped_lock lock(shard.latch_);
+      if (!read) {
+        // The pin is released below, with those of the fetchers that found the page being loaded.
+        DropUnreadFrame(shard, page, false);
+        continue;
+      }
+      page->is_io_pending_ = false;
+      shard.io_cv_.notify_all();
+    }
+  }
+
+  for (size_t i = 0; i < pages.size(); ++i) {
+    auto page = pages[i];
+    if (page == nullptr) {
+      continue;
+    }
+    if (page->is_io_pending_) {
+      auto wait_start = std::chrono::steady_clock::now();
+      auto &shard = ShardOf(page_ids[i]);
+      std::unique_lock<std::mutex> lock(shard.latch_);
+      shard.io_cv_.wait(lock, [page] { return !page->is_io_pending_; });
+      pin_wait_latency_.RecordSince(wait_start);
+    }
+    if (page->page_id_ != page_ids[i]) {
+      UnpinFrame(page, false);
+      pages[i] = nullptr;
+      continue;
+    }
+    if (page->is_prefetched_.exchange(false)) {
+      page->pin_count_--;
+    }
+  }
+  return pages;
+}
+
+auto BufferPoolManager::TryPinResident(Shard &shard, page_id_t page_id) -> Page * {
+  frame_id_t frame_id;
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
+    return nullptr;
+  }
+  auto page = &pages_[frame_id];
+  auto pin_count = page->pin_count_.load();
+  do {
+    if (pin_count < 0) {
+      return nullptr;
     }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // The frame may have been given to another page between the lookup and the pin.
+  if (page->page_id_ != page_id) {
+    page->pin_count_--;
+    return nullptr;
   }
   return page;
 }
 
-auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  std::lock_guard<std::mutex> lock(latch_);
-  if (page_table_.count(page_id) != 0) {
-    auto frame_id = page_table_[page_id];
-    auto page = &pages_[frame_id];
-    page->is_dirty_ = page->is_dirty_ || is_dirty;
-    if (page->pin_count_ <= 0) {
+auto BufferPoolManager::UnpinFrame(Page *page, bool is_dirty) -> bool {
+  // Set the flag before unpinning, a frame can only be taken for another page once it is unpinned.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  auto pin_count = page->pin_count_.load();
+  do {
+    if (pin_count <= 0) {
       return false;
     }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  return true;
+}
 
-    page->pin_count_--;
-    if (page->pin_count_ == 0) {
-      replacer_->SetEvictable(frame_id, true);
+void BufferPoolManager::RecordHit(Shard &shard, page_id_t page_id, AccessType access_type) {
+  auto slot = shard.access_buffer_next_.fetch_add(1, std::memory_order_relaxed) % ACCESS_BUFFER_SIZE;
+  shard.access_buffer_[slot].store((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) + 1) << 8 |
+                                       static_cast<uint64_t>(access_type),
+                                   std::memory_order_relaxed);
+  if (slot == ACCESS_BUFFER_SIZE - 1) {
+    std::unique_lock<std::mutex> lock(shard.latch_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      DrainAccesses(shard);
     }
-    return true;
   }
-  return false;
 }
 
-auto BufferPoolManager::FlushPageCommon(page_id_t page_id) -> bool {
-  if (page_table_.count(page_id) != 0) {
-    auto page = &pages_[page_table_[page_id]];
-    disk_manager_->WritePage(page_id, page->GetData());
-    page->is_dirty_ = false;
+void BufferPoolManager::DrainAccesses(Shard &shard) {
+  for (auto &slot : shard.access_buffer_) {
+    auto access = slot.exchange(0, std::memory_order_relaxed);
+    if (access == 0) {
+      continue;
+    }
+    auto page_id = static_cast<page_id_t>((access >> 8) - 1);
+    frame_id_t frame_id;
+    // Skip the hits of pages that left the pool since.
+    if (shard.page_table_.Find(page_id, &frame_id)) {
+      shard.replacer_->RecordAccess(frame_id - shard.frame_offset_, static_cast<AccessType>(access & 0xFF));
+      replacer_sampled_hits_.Add();
+    }
+  }
+}
+
+auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto &shard = ShardOf(page_id);
+  // A pinned page stays in its frame, so the page table can be read without the latch as long as the caller holds a
+  // pin. Only an unpin of a page that is not pinned, or a lookup that missed the page, needs the latch.
+  frame_id_t frame_id;
+  if (shard.page_table_.Find(page_id, &frame_id) && pages_[frame_id].page_id_ == page_id &&
+      UnpinFrame(&pages_[frame_id], is_dirty)) {
     return true;
   }
-  return false;
+  std::lock_guard<std::mutex> lock(shard.latch_);
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  return UnpinFrame(&pages_[frame_id], is_dirty);
+}
+
+auto BufferPoolManager::FlushPageCommon(Shard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id) -> bool {
+  frame_id_t frame_id;
+  if (!shard.page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+
+  auto page = &pages_[frame_id];
+  // Pin the frame so that it cannot be evicted while the latch is dropped for the write.
+  page->pin_count_++;
+  shard.io_cv_.wait(lock, [page] { return !page->is_io_pending_; });
+  if (page->page_id_ != page_id) {
+    page->pin_count_--;
+    return false;
+  }
+  // Clear the flag before writing, so that an UnpinPage(is_dirty = true) racing with the write is not lost.
+  page->is_dirty_ = false;
+  lock.unlock();
+  bool written = SchedulePageIO(true, page_id, page->GetData()).get();
+  lock.lock();
+
+  if (!written) {
+    page->is_dirty_ = true;
+  }
+  page->pin_count_--;
+  return written;
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  std::lock_guard<std::mutex> lock(latch_);
-  return FlushPageCommon(page_id);
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto &shard = ShardOf(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  return FlushPageCommon(shard, lock, page_id);
 }
 
 void BufferPoolManager::FlushAllPages() {
-  std::lock_guard<std::mutex> lock(latch_);
-  for (size_t fid_it = 0; fid_it < pool_size_; ++fid_it) {
-    FlushPageCommon(pages_[fid_it].page_id_);
+  WriteBackFrames([this](Shard &shard) {
+    std::vector<frame_id_t> frame_ids;
+    shard.page_table_.ForEach([this, &frame_ids](page_id_t page_id, frame_id_t frame_id) {
+      // The frame is being loaded from disk, or holds a new page whose victim is being written back: its content is
+      // already on disk or not written yet.
+      if (!pages_[frame_id].is_io_pending_) {
+        frame_ids.push_back(frame_id);
+      }
+    });
+    return frame_ids;
+  });
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->Flush();
+  }
+}
+
+auto BufferPoolManager::WriteBackFrames(const std::function<std::vector<frame_id_t>(Shard &)> &select) -> size_t {
+  // Pin the selected pages of every shard first and schedule all the writes at once: with page ids striped over the
+  // shards, adjacent pages can only be merged into one write across shards.
+  std::vector<std::vector<frame_id_t>> pinned_frames(shards_.size());
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto &shard = *shards_[i];
+    std::scoped_lock lock(shard.latch_);
+    pinned_frames[i] = select(shard);
+    for (auto frame_id : pinned_frames[i]) {
+      auto page = &pages_[frame_id];
+      page->pin_count_++;
+      // Clear the flag before writing, so that an UnpinPage(is_dirty = true) racing with the write is not lost.
+      page->is_dirty_ = false;
+      auto promise = disk_scheduler_->CreatePromise();
+      futures.push_back(promise.get_future());
+      requests.push_back({true, page->GetData(), page->page_id_, std::move(promise)});
+    }
+  }
+  if (requests.empty()) {
+    return 0;
+  }
+
+  disk_scheduler_->Schedule(std::move(requests));
+  std::vector<bool> written;
+  for (auto &future : futures) {
+    written.push_back(future.get());
+  }
+
+  size_t num_written = 0;
+  size_t next = 0;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto &shard = *shards_[i];
+    std::scoped_lock lock(shard.latch_);
+    for (auto frame_id : pinned_frames[i]) {
+      if (written[next++]) {
+        num_written++;
+      } else {
+        pages_[frame_id].is_dirty_ = true;
+      }
+      pages_[frame_id].pin_count_--;
+    }
+  }
+  return num_written;
+}
+
+void BufferPoolManager::Resize(size_t pool_size, std::chrono::milliseconds timeout) {
+  BUSTUB_ENSURE(pool_size >= shards_.size() && pool_size <= max_pool_size_, "invalid buffer pool size");
+  std::scoped_lock resize_lock(resize_latch_);
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  bool drained = true;
+  size_t new_pool_size = 0;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto &shard = *shards_[i];
+    auto num_frames = ShardShare(pool_size, shards_.size(), i);
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    if (num_frames < shard.num_frames_) {
+      lock.unlock();
+      drained = ShrinkShard(shard, num_frames, deadline) && drained;
+      lock.lock();
+      new_pool_size += shard.num_frames_;
+      continue;
+    }
+    // The frames past the end were drained when the shard last shrank, or never used.
+    for (auto j = shard.num_frames_; j < num_frames; ++j) {
+      shard.free_list_.emplace_back(shard.frame_offset_ + static_cast<frame_id_t>(j));
+    }
+    shard.num_frames_ = num_frames;
+    new_pool_size += num_frames;
+  }
+  pool_size_ = new_pool_size;
+  if (!drained) {
+    throw Exception(ExceptionType::INVALID,
+                    fmt::format("buffer pool shrunk to {} frames only, the other frames are pinned", new_pool_size));
+  }
+}
+
+auto BufferPoolManager::ShrinkShard(Shard &shard, size_t num_frames, std::chrono::steady_clock::time_point deadline)
+    -> bool {
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto old_num_frames = shard.num_frames_;
+  auto end = shard.frame_offset_ + static_cast<frame_id_t>(num_frames);
+  // From now on the frames past the end are not handed out from the free list, and DeletePage() and evictions that
+  // still put some back are caught by the next round below.
+  shard.num_frames_ = num_frames;
+  std::vector<frame_id_t> remaining;
+  for (auto frame_id = end; frame_id < shard.frame_offset_ + static_cast<frame_id_t>(old_num_frames); ++frame_id) {
+    remaining.push_back(frame_id);
+  }
+
+  while (true) {
+    shard.free_list_.remove_if([end](frame_id_t frame_id) { return frame_id >= end; });
+    DrainAccesses(shard);
+    std::vector<frame_id_t> pinned;
+    std::vector<Page *> dirty_pages;
+    for (auto frame_id : remaining) {
+      auto page = &pages_[frame_id];
+      if (page->page_id_ == INVALID_PAGE_ID) {
+        continue;
+      }
+      // A page read ahead and never fetched only holds the pin of the read-ahead, which is released.
+      if (!page->is_io_pending_ && page->is_prefetched_.exchange(false)) {
+        page->pin_count_--;
+      }
+      // Taking the frame like an eviction keeps hits and evictions away from it.
+      int pin_count = 0;
+      if (!page->pin_count_.compare_exchange_strong(pin_count, -1)) {
+        pinned.push_back(frame_id);
+        continue;
+      }
+      shard.replacer_->Remove(frame_id - shard.frame_offset_);
+      shard.page_table_.Erase(page->page_id_);
+      if (page->is_dirty_) {
+        // Fetchers of the page wait for the write-back to land before reading it again.
+        shard.writeback_pages_.insert(page->page_id_);
+        dirty_pages.push_back(page);
+      } else {
+        page->page_id_ = INVALID_PAGE_ID;
+        page->pin_count_ = 0;
+      }
+    }
+
+    if (!dirty_pages.empty()) {
+      std::vector<DiskRequest> requests;
+      std::vector<std::future<bool>> futures;
+      for (auto page : dirty_pages) {
+        auto promise = disk_scheduler_->CreatePromise();
+        futures.push_back(promise.get_future());
+        requests.push_back({true, page->GetData(), page->page_id_, std::move(promise)});
+      }
+      lock.unlock();
+      disk_scheduler_->Schedule(std::move(requests));
+      std::vector<bool> written;
+      for (auto &future : futures) {
+        written.push_back(future.get());
+      }
+      lock.lock();
+      for (size_t j = 0; j < dirty_pages.size(); ++j) {
+        auto page = dirty_pages[j];
+        shard.writeback_pages_.erase(page->page_id_);
+        if (!written[j]) {
+          // The page stays resident and dirty, and its write is tried again with the next round like a pinned frame.
+          auto frame_id = static_cast<frame_id_t>(page - pages_);
+          shard.page_table_.Insert(page->page_id_, frame_id);
+          shard.replacer_->RecordLoad(frame_id - shard.frame_offset_, page->page_id_);
+          shard.replacer_->RecordAccess(frame_id - shard.frame_offset_, AccessType::Unknown);
+          shard.replacer_->SetEvictable(frame_id - shard.frame_offset_, true);
+          page->pin_count_ = 0;
+          pinned.push_back(frame_id);
+          continue;
+        }
+        dirty_evictions_++;
+        page->is_dirty_ = false;
+        page->page_id_ = INVALID_PAGE_ID;
+        page->pin_count_ = 0;
+      }
+      shard.io_cv_.notify_all();
+    }
+
+    if (pinned.empty()) {
+      break;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      // Keep the frames up to the last pinned one, the drained ones among them go back to the free list.
+      auto pinned_end = *std::max_element(pinned.begin(), pinned.end()) + 1;
+      shard.free_list_.remove_if([end](frame_id_t frame_id) { return frame_id >= end; });
+      for (auto frame_id = end; frame_id < pinned_end; ++frame_id) {
+        if (pages_[frame_id].page_id_ == INVALID_PAGE_ID) {
+          shard.free_list_.push_back(frame_id);
+        }
+      }
+      end = pinned_end;
+      shard.num_frames_ = static_cast<size_t>(end - shard.frame_offset_);
+      break;
+    }
+    // Give the holders of the remaining pins a moment, without holding up the fetches of the shard.
+    remaining = std::move(pinned);
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    lock.lock();
+  }
+  shard.free_list_.remove_if([end](frame_id_t frame_id) { return frame_id >= end; });
+
+  auto num_released = old_num_frames - shard.num_frames_;
+  if (!frame_arena_->Release(static_cast<size_t>(end), num_released)) {
+    // Frames taken from the free list are expected to be zeroed.
+    for (size_t i = 0; i < num_released; ++i) {
+      pages_[end + i].ResetMemory();
+    }
+  }
+  return shard.num_frames_ == num_frames;
+}
+
+void BufferPoolManager::StartBackgroundWriter(double target_clean_ratio, std::chrono::milliseconds interval) {
+  BUSTUB_ENSURE(target_clean_ratio > 0 && target_clean_ratio <= 1, "invalid clean frame ratio");
+  if (bg_writer_.joinable()) {
+    return;
+  }
+  bg_writer_stop_ = false;
+  bg_writer_ = std::thread([this, target_clean_ratio, interval] { BackgroundWriterLoop(target_clean_ratio, interval); });
+}
+
+void BufferPoolManager::StopBackgroundWriter() {
+  if (!bg_writer_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock lock(bg_writer_latch_);
+    bg_writer_stop_ = true;
+  }
+  bg_writer_cv_.notify_all();
+  bg_writer_.join();
+}
+
+void BufferPoolManager::BackgroundWriterLoop(double target_clean_ratio, std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(bg_writer_latch_);
+  while (!bg_writer_cv_.wait_for(lock, interval, [this] { return bg_writer_stop_; })) {
+    lock.unlock();
+    background_writes_ += WriteBackFrames([this, target_clean_ratio](Shard &shard) {
+      std::vector<frame_id_t> frame_ids;
+      auto target = static_cast<size_t>(std::ceil(static_cast<double>(shard.num_frames_) * target_clean_ratio));
+      if (shard.free_list_.size() >= target) {
+        return frame_ids;
+      }
+      // The frames that will be evicted next should be clean by the time the eviction happens.
+      DrainAccesses(shard);
+      for (auto frame_id : shard.replacer_->EvictionCandidates(target - shard.free_list_.size())) {
+        auto page = &pages_[frame_id + shard.frame_offset_];
+        // Pinned frames stay in the replacer, skip them: they are not about to be evicted.
+        if (page->is_dirty_ && !page->is_io_pending_ && page->pin_count_ == 0) {
+          frame_ids.push_back(frame_id + shard.frame_offset_);
+        }
+      }
+      return frame_ids;
+    });
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  {
+    std::scoped_lock lock(read_ahead_latch_);
+    // A scan that runs ahead of the disk by more than the whole pool would only evict its own read-ahead.
+    if (read_ahead_queue_.size() >= pool_size_) {
+      return;
+    }
+    read_ahead_queue_.insert(read_ahead_queue_.end(), page_ids.begin(), page_ids.end());
+    if (!read_ahead_thread_.joinable()) {
+      read_ahead_thread_ = std::thread([this] { ReadAheadLoop(); });
+    }
+  }
+  read_ahead_cv_.notify_one();
+}
+
+void BufferPoolManager::ReadAheadLoop() {
+  std::unique_lock<std::mutex> lock(read_ahead_latch_);
+  while (true) {
+    read_ahead_cv_.wait(lock, [this] { return read_ahead_stop_ || !read_ahead_queue_.empty(); });
+    if (read_ahead_stop_) {
+      return;
+    }
+    // Pages being read ahead stay pinned until their read completes, never reserve more than a quarter of the pool.
+    auto max_batch = std::max<size_t>(1, pool_size_ / 4);
+    auto batch_size = std::min(max_batch, read_ahead_queue_.size());
+    std::vector<page_id_t> page_ids(read_ahead_queue_.begin(), read_ahead_queue_.begin() + batch_size);
+    read_ahead_queue_.erase(read_ahead_queue_.begin(), read_ahead_queue_.begin() + batch_size);
+    lock.unlock();
+    ReadAheadPages(page_ids, max_batch);
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::ReadAheadPages(const std::vector<page_id_t> &page_ids, size_t max_pinned) {
+  // Release the pages read ahead the longest ago that were not fetched yet.
+  while (!read_ahead_pinned_.empty() && read_ahead_pinned_.size() + page_ids.size() > max_pinned) {
+    auto page_id = read_ahead_pinned_.front();
+    read_ahead_pinned_.pop_front();
+    auto &shard = ShardOf(page_id);
+    std::scoped_lock lock(shard.latch_);
+    frame_id_t frame_id;
+    if (shard.page_table_.Find(page_id, &frame_id) && pages_[frame_id].is_prefetched_.exchange(false)) {
+      pages_[frame_id].pin_count_--;
+    }
+  }
+
+  prefetch_count_ += LoadPages(page_ids, true);
+}
+
+auto BufferPoolManager::LoadPages(const std::vector<page_id_t> &page_ids, bool read_ahead) -> size_t {
+  size_t num_cached = 0;
+  std::vector<Page *> pages;
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (auto page_id : page_ids) {
+    if (page_id < 0) {
+      continue;
+    }
+    auto &shard = ShardOf(page_id);
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    // A page id the shard has not handed out yet must not get a frame, NewPage() would install it a second time.
+    frame_id_t frame_id;
+    if (!disk_manager_->IsAllocated(page_id) || shard.page_table_.Find(page_id, &frame_id) ||
+        shard.writeback_pages_.count(page_id) != 0) {
+      continue;
+    }
+    // Read-ahead is only worth it if it does not have to wait for a write-back, leave dirty victims to the fetchers.
+    if (shard.free_list_.empty()) {
+      if (!read_ahead) {
+        continue;
+      }
+      auto candidates = shard.replacer_->EvictionCandidates(1);
+      if (candidates.empty() || pages_[candidates[0] + shard.frame_offset_].is_dirty_) {
+        continue;
+      }
+    }
+    // The frame stays I/O pending until its read completes, fetchers of the page wait for it.
+    auto page = GetAvailablePage(shard, lock, page_id, AccessType::Scan, false, true);
+    if (page == nullptr) {
+      continue;
+    }
+    if (read_ahead) {
+      page->is_prefetched_ = true;
+      read_ahead_pinned_.push_back(page_id);
+    }
+    if (ReadFromCompressedCache(page)) {
+      page->is_io_pending_ = false;
+      if (!read_ahead) {
+        UnpinFrame(page, false);
+      }
+      shard.io_cv_.notify_all();
+      num_cached++;
+      continue;
+    }
+    pages.push_back(page);
+    auto promise = disk_scheduler_->CreatePromise();
+    futures.push_back(promise.get_future());
+    requests.push_back({false, page->GetData(), page_id, std::move(promise)});
+  }
+  if (requests.empty()) {
+    return num_cached;
+  }
+
+  disk_scheduler_->Schedule(std::move(requests));
+  size_t num_read = 0;
+  for (size_t i = 0; i < pages.size(); ++i) {
+    bool read = futures[i].get();
+    auto page = pages[i];
+    auto &shard = ShardOf(page->page_id_);
+    std::scoped_lock lock(shard.latch_);
+    if (!read) {
+      // A fetch may have taken over the pin of the read-ahead already, it drops its own pin then.
+      DropUnreadFrame(shard, page, !read_ahead || page->is_prefetched_.exchange(false));
+      continue;
+    }
+    num_read++;
+    page->is_io_pending_ = false;
+    if (!read_ahead) {
+      UnpinFrame(page, false);
+    }
+    shard.io_cv_.notify_all();
+  }
+  return num_cached + num_read;
+}
+
+auto BufferPoolManager::DumpResidentPages(const std::string &path) -> size_t {
+  std::vector<std::pair<double, page_id_t>> resident_pages;
+  for (auto &shard : shards_) {
+    std::scoped_lock lock(shard->latch_);
+    DrainAccesses(*shard);
+    auto candidates = shard->replacer_->EvictionCandidates(shard->num_frames_);
+    std::unordered_map<frame_id_t, size_t> positions;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      positions[candidates[i] + shard->frame_offset_] = i;
+    }
+    shard->page_table_.ForEach([&](page_id_t page_id, frame_id_t frame_id) {
+      auto it = positions.find(frame_id);
+      double heat = 1;
+      if (it != positions.end() && pages_[frame_id].pin_count_ == 0) {
+        heat = static_cast<double>(it->second + 1) / static_cast<double>(candidates.size() + 1);
+      }
+      resident_pages.emplace_back(heat, page_id);
+    });
+  }
+  std::sort(resident_pages.begin(), resident_pages.end(),
+            [](const auto &a, const auto &b) { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    throw Exception(ExceptionType::INVALID, "can't write the resident pages to " + path);
+  }
+  auto num_pages = static_cast<uint64_t>(resident_pages.size());
+  out.write(reinterpret_cast<const char *>(&num_pages), sizeof(num_pages));
+  for (const auto &[heat, page_id] : resident_pages) {
+    out.write(reinterpret_cast<const char *>(&page_id), sizeof(page_id));
+    out.write(reinterpret_cast<const char *>(&heat), sizeof(heat));
+  }
+  return resident_pages.size();
+}
+
+auto BufferPoolManager::StartWarmUp(const std::string &path) -> size_t {
+  WaitForWarmUp();
+  std::ifstream in(path, std::ios::binary);
+  uint64_t num_pages = 0;
+  if (!in.is_open() || !in.read(reinterpret_cast<char *>(&num_pages), sizeof(num_pages))) {
+    return 0;
+  }
+  // Pages are saved hottest first, the pages that don't fit into the pool are the coldest.
+  std::vector<page_id_t> page_ids;
+  for (uint64_t i = 0; i < num_pages && page_ids.size() < pool_size_; ++i) {
+    page_id_t page_id;
+    double heat;
+    if (!in.read(reinterpret_cast<char *>(&page_id), sizeof(page_id)) ||
+        !in.read(reinterpret_cast<char *>(&heat), sizeof(heat))) {
+      break;
+    }
+    // The file may be older than the last deallocations.
+    if (disk_manager_->IsAllocated(page_id)) {
+      page_ids.push_back(page_id);
+    }
+  }
+  if (page_ids.empty()) {
+    return 0;
+  }
+
+  warm_up_pages_ = page_ids.size();
+  warmed_up_pages_ = 0;
+  warm_up_stop_ = false;
+  warm_up_thread_ = std::thread([this, page_ids = std::move(page_ids)] {
+    for (size_t begin = 0; begin < page_ids.size() && !warm_up_stop_; begin += WARM_UP_BATCH_SIZE) {
+      auto end = std::min(page_ids.size(), begin + WARM_UP_BATCH_SIZE);
+      std::vector<page_id_t> batch(page_ids.begin() + begin, page_ids.begin() + end);
+      std::sort(batch.begin(), batch.end());
+      LoadPages(batch, false);
+      warmed_up_pages_ += batch.size();
+    }
+  });
+  return warm_up_pages_;
+}
+
+void BufferPoolManager::WaitForWarmUp() {
+  if (warm_up_thread_.joinable()) {
+    warm_up_thread_.join();
   }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  std::lock_guard<std::mutex> lock(latch_);
-  if (page_table_.count(page_id) != 0) {
-    auto frame_id = page_table_[page_id];
-    auto page = &pages_[frame_id];
-    if (page->pin_count_ > 0) {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  auto &shard = ShardOf(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  // A write-back still in flight would land on the page after its id was handed out again.
+  shard.io_cv_.wait(lock, [&shard, page_id] { return shard.writeback_pages_.count(page_id) == 0; });
+  frame_id_t frame_id;
+  if (shard.page_table_.Find(page_id, &frame_id)) {
+    if (!FreeFrame(shard, frame_id)) {
       return false;
     }
-    replacer_->Remove(frame_id);
-    free_list_.emplace_back(frame_id);
-    page_table_.erase(page_id);
-    page->ResetMemory();
-    page->pin_count_ = 0;
-    page->is_dirty_ = false;
-    page_id = INVALID_PAGE_ID;
-    DeallocatePage(page_id);
+  } else if (compressed_cache_ != nullptr) {
+    compressed_cache_->Erase(page_id);
   }
+  DeallocatePage(page_id);
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManager::FreeFrame(Shard &shard, frame_id_t frame_id) -> bool {
+  auto page = &pages_[frame_id];
+  // A page read ahead and never fetched only holds the pin of the read-ahead, which is released.
+  if (!page->is_io_pending_ && page->is_prefetched_.exchange(false)) {
+    page->pin_count_--;
+  }
+  // A frame with I/O in flight is always pinned by the thread performing it. Taking the frame keeps hits away.
+  int pin_count = 0;
+  if (!page->pin_count_.compare_exchange_strong(pin_count, -1)) {
+    return false;
+  }
+  shard.replacer_->Remove(frame_id - shard.frame_offset_);
+  shard.page_table_.Erase(page->page_id_);
+  page->ResetMemory();
+  page->is_dirty_ = false;
+  page->page_id_ = INVALID_PAGE_ID;
+  page->pin_count_ = 0;
+  shard.free_list_.emplace_back(frame_id);
+  return true;
+}
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, FetchPage(page_id)}; }
+auto BufferPoolManager::AllocatePage(Shard &shard) -> page_id_t {
+  return disk_manager_->AllocatePage(shards_.size(), shard.index_);
+}
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
-  auto page = FetchPage(page_id);
+auto BufferPoolManager::GetHitCount(AccessType access_type) -> size_t {
+  size_t count = 0;
+  for (auto &shard : shards_) {
+    count += shard->hits_[static_cast<size_t>(access_type)].Get();
+  }
+  return count;
+}
+
+auto BufferPoolManager::GetMissCount(AccessType access_type) -> size_t {
+  size_t count = 0;
+  for (auto &shard : shards_) {
+    count += shard->misses_[static_cast<size_t>(access_type)].Get();
+  }
+  return count;
+}
+
+auto BufferPoolManager::GetMetrics() -> MetricList {
+  static constexpr const char *ACCESS_TYPE_NAMES[NUM_ACCESS_TYPES] = {"unknown", "get", "scan"};
+  MetricList metrics;
+  size_t resident_pages = 0;
+  size_t free_frames = 0;
+  size_t evictable_frames = 0;
+  for (auto &shard : shards_) {
+    std::scoped_lock lock(shard->latch_);
+    resident_pages += shard->page_table_.Size();
+    free_frames += shard->free_list_.size();
+    evictable_frames += shard->replacer_->Size();
+  }
+  metrics.emplace_back("bpm.pool_size", pool_size_);
+  metrics.emplace_back("bpm.resident_pages", resident_pages);
+  metrics.emplace_back("bpm.free_frames", free_frames);
+
+  size_t hits = 0;
+  size_t misses = 0;
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; ++i) {
+    auto type_hits = GetHitCount(static_cast<AccessType>(i));
+    auto type_misses = GetMissCount(static_cast<AccessType>(i));
+    metrics.emplace_back(fmt::format("bpm.hits.{}", ACCESS_TYPE_NAMES[i]), type_hits);
+    metrics.emplace_back(fmt::format("bpm.misses.{}", ACCESS_TYPE_NAMES[i]), type_misses);
+    hits += type_hits;
+    misses += type_misses;
+  }
+  metrics.emplace_back("bpm.hit_ratio_pct", hits + misses == 0 ? 0 : hits * 100 / (hits + misses));
+  metrics.emplace_back("bpm.evictions.clean", clean_evictions_);
+  metrics.emplace_back("bpm.evictions.dirty", dirty_evictions_);
+  metrics.emplace_back("bpm.background_writes", background_writes_);
+  metrics.emplace_back("bpm.prefetches", prefetch_count_);
+  metrics.emplace_back("bpm.warm_up.pages", warm_up_pages_);
+  metrics.emplace_back("bpm.warm_up.done", warmed_up_pages_);
+  miss_latency_.AppendTo("bpm.miss", &metrics);
+  pin_wait_latency_.AppendTo("bpm.pin_wait", &metrics);
+
+  metrics.emplace_back("replacer.evictable_frames", evictable_frames);
+  metrics.emplace_back("replacer.pinned_victims", replacer_pinned_victims_.Get());
+  metrics.emplace_back("replacer.sampled_hits", replacer_sampled_hits_.Get());
+
+  metrics.emplace_back("disk.writes", disk_manager_->GetNumWrites());
+  metrics.emplace_back("disk.flushes", disk_manager_->GetNumFlushes());
+  metrics.emplace_back("disk.pages", disk_manager_->GetNumPages());
+  metrics.emplace_back("disk.free_pages", disk_manager_->GetNumFreePages());
+  disk_scheduler_->GetReadLatency().AppendTo("disk.read", &metrics);
+  disk_scheduler_->GetWriteLatency().AppendTo("disk.write", &metrics);
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->AppendMetrics(&metrics);
+  }
+  return metrics;
+}
+
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
+  return {this, FetchPage(page_id, access_type)};
+}
+
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
+  auto page = FetchPage(page_id, access_type);
   page->RLatch();
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
-  auto page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
+  auto page = FetchPage(page_id, access_type);
   page->WLatch();
   return {this, page};
 }
 
+auto BufferPoolManager::FetchPageOptimistic(page_id_t page_id, AccessType access_type) -> OptimisticReadPageGuard {
+  return {this, FetchPage(page_id, access_type)};
+}
+
+auto BufferPoolManager::FetchPagesBasic(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<BasicPageGuard> {
+  std::vector<BasicPageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (auto page : FetchPages(page_ids, access_type)) {
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
+
+auto BufferPoolManager::FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<ReadPageGuard> {
+  std::vector<ReadPageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (auto page : FetchPages(page_ids, access_type)) {
+    if (page != nullptr) {
+      page->RLatch();
+    }
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
+
+auto BufferPoolManager::FetchPagesWrite(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<WritePageGuard> {
+  std::vector<WritePageGuard> guards;
+  guards.reserve(page_ids.size());
+  for (auto page : FetchPages(page_ids, access_type)) {
+    if (page != nullptr) {
+      page->WLatch();
+    }
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
+
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
 
 }  // namespace bustub
@@ -0,0 +1,293 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.cpp
+//
+// Identification: src/buffer/clock_pro_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ClockProReplacer::ClockProReplacer(size_t num_frames)
+    : num_frames_(num_frames),
+      hand_hot_(clock_.end()),
+      hand_cold_(clock_.end()),
+      hand_test_(clock_.end()),
+      cold_target_(std::max<size_t>(1, num_frames / 4)),
+      is_tracked_(num_frames, false),
+      is_evictable_(num_frames, false),
+      entry_of_(num_frames),
+      loaded_page_(num_frames, INVALID_PAGE_ID) {}
+
+auto ClockProReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (num_evictable_ == 0) {
+    return false;
+  }
+
+  // Every step clears a reference bit, ends a test period or demotes a hot page, so this terminates.
+  while (true) {
+    if (num_evictable_cold_ > 0) {
+      if (RunHandCold(frame_id)) {
+        return true;
+      }
+    } else {
+      RunHandHot();
+    }
+  }
+}
+
+void ClockProReplacer::RecordLoad(frame_id_t frame_id, page_id_t page_id) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+  loaded_page_[frame_id] = page_id;
+}
+
+void ClockProReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (is_tracked_[frame_id]) {
+    if (access_type != AccessType::Scan) {
+      entry_of_[frame_id]->is_referenced_ = true;
+    }
+    return;
+  }
+
+  auto page_id = loaded_page_[frame_id];
+  loaded_page_[frame_id] = INVALID_PAGE_ID;
+  bool is_hot;
+  if (auto it = non_resident_.find(page_id); it != non_resident_.end() && page_id != INVALID_PAGE_ID) {
+    // Reused within its test period: the page's reuse distance is short, and cold pages deserve more room.
+    EraseNonResident(it->second);
+    cold_target_ = std::min(num_frames_, cold_target_ + 1);
+    is_hot = access_type != AccessType::Scan;
+  } else {
+    // Until the hot set is full, a page accessed for the first time is as good a candidate as any.
+    is_hot = access_type != AccessType::Scan && num_hot_ < HotTarget();
+  }
+
+  auto it = Insert({page_id, frame_id, false, false, !is_hot && access_type != AccessType::Scan});
+  is_tracked_[frame_id] = true;
+  entry_of_[frame_id] = it;
+  if (is_hot) {
+    SetHot(&*it, true);
+    while (num_hot_ > HotTarget()) {
+      RunHandHot();
+    }
+  }
+}
+
+void ClockProReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (!is_tracked_[frame_id] || is_evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  is_evictable_[frame_id] = set_evictable;
+  size_t is_cold = entry_of_[frame_id]->is_hot_ ? 0 : 1;
+  if (set_evictable) {
+    num_evictable_++;
+    num_evictable_cold_ += is_cold;
+  } else {
+    num_evictable_--;
+    num_evictable_cold_ -= is_cold;
+  }
+}
+
+void ClockProReplacer::Remove(frame_id_t frame_id) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (!is_tracked_[frame_id]) {
+    return;
+  }
+  BUSTUB_ENSURE(is_evictable_[frame_id], "Remove is called on a non-evictable frame");
+  auto it = entry_of_[frame_id];
+  SetHot(&*it, false);
+  num_evictable_--;
+  num_evictable_cold_--;
+  is_tracked_[frame_id] = false;
+  is_evictable_[frame_id] = false;
+  Erase(it);
+}
+
+auto ClockProReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  if (clock_.empty()) {
+    return candidates;
+  }
+
+  // HAND_cold takes unreferenced cold pages first; referenced ones and hot pages need more passes of the hands.
+  for (bool is_hot : {false, true}) {
+    for (bool is_referenced : {false, true}) {
+      auto it = hand_cold_;
+      for (size_t i = 0; i < clock_.size() && candidates.size() < max_frames; i++) {
+        const auto &entry = *it;
+        if (entry.frame_id_ != INVALID_FRAME_ID && is_evictable_[entry.frame_id_] && entry.is_hot_ == is_hot &&
+            entry.is_referenced_ == is_referenced) {
+          candidates.push_back(entry.frame_id_);
+        }
+        Advance(&it);
+      }
+    }
+  }
+  return candidates;
+}
+
+auto ClockProReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> lock(latch_);
+  return num_evictable_;
+}
+
+auto ClockProReplacer::Insert(const Entry &entry) -> Clock::iterator {
+  auto it = clock_.insert(hand_hot_, entry);
+  for (auto *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+    if (*hand == clock_.end()) {
+      *hand = it;
+    }
+  }
+  return it;
+}
+
+void ClockProReplacer::Erase(Clock::iterator it) {
+  for (auto *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+    if (*hand == it) {
+      Advance(hand);
+      if (*hand == it) {
+        *hand = clock_.end();
+      }
+    }
+  }
+  clock_.erase(it);
+}
+
+void ClockProReplacer::Advance(Clock::iterator *hand) {
+  if (clock_.empty()) {
+    *hand = clock_.end();
+    return;
+  }
+  if (*hand != clock_.end()) {
+    ++*hand;
+  }
+  if (*hand == clock_.end()) {
+    *hand = clock_.begin();
+  }
+}
+
+auto ClockProReplacer::RunHandCold(frame_id_t *frame_id) -> bool {
+  auto it = hand_cold_;
+  Advance(&hand_cold_);
+  auto &entry = *it;
+  if (entry.frame_id_ == INVALID_FRAME_ID || entry.is_hot_ || !is_evictable_[entry.frame_id_]) {
+    return false;
+  }
+
+  if (entry.is_referenced_) {
+    entry.is_referenced_ = false;
+    if (entry.in_test_) {
+      entry.in_test_ = false;
+      SetHot(&entry, true);
+      while (num_hot_ > HotTarget()) {
+        RunHandHot();
+      }
+    } else {
+      entry.in_test_ = true;
+      clock_.splice(hand_hot_, clock_, it);
+    }
+    return false;
+  }
+
+  *frame_id = entry.frame_id_;
+  num_evictable_--;
+  num_evictable_cold_--;
+  is_tracked_[entry.frame_id_] = false;
+  is_evictable_[entry.frame_id_] = false;
+  if (!entry.in_test_ || entry.page_id_ == INVALID_PAGE_ID) {
+    Erase(it);
+    return true;
+  }
+
+  // Keep the page on the clock until its test period ends, a reload before that makes it hot.
+  entry.frame_id_ = INVALID_FRAME_ID;
+  non_resident_[entry.page_id_] = it;
+  while (non_resident_.size() > num_frames_) {
+    RunHandTest();
+  }
+  return true;
+}
+
+void ClockProReplacer::RunHandHot() {
+  auto it = hand_hot_;
+  Advance(&hand_hot_);
+  auto &entry = *it;
+  if (entry.frame_id_ == INVALID_FRAME_ID) {
+    EraseNonResident(it);
+    cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+    return;
+  }
+  if (!entry.is_hot_) {
+    if (entry.in_test_) {
+      EndTestPeriod(&entry);
+    }
+    return;
+  }
+  if (entry.is_referenced_) {
+    entry.is_referenced_ = false;
+  } else {
+    SetHot(&entry, false);
+  }
+}
+
+void ClockProReplacer::RunHandTest() {
+  auto it = hand_test_;
+  Advance(&hand_test_);
+  auto &entry = *it;
+  if (entry.frame_id_ == INVALID_FRAME_ID) {
+    EraseNonResident(it);
+    cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+  } else if (!entry.is_hot_ && entry.in_test_) {
+    EndTestPeriod(&entry);
+  }
+}
+
+void ClockProReplacer::EraseNonResident(Clock::iterator it) {
+  non_resident_.erase(it->page_id_);
+  Erase(it);
+}
+
+void ClockProReplacer::SetHot(Entry *entry, bool is_hot) {
+  if (entry->is_hot_ == is_hot) {
+    return;
+  }
+  entry->is_hot_ = is_hot;
+  if (is_hot) {
+    num_hot_++;
+  } else {
+    num_hot_--;
+  }
+  if (is_evictable_[entry->frame_id_]) {
+    if (is_hot) {
+      num_evictable_cold_--;
+    } else {
+      num_evictable_cold_++;
+    }
+  }
+}
+
+void ClockProReplacer::EndTestPeriod(Entry *entry) {
+  entry->in_test_ = false;
+  cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+}
+
+}  // namespace bustub
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "buffer/page_compressor.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+CompressedPageCache::CompressedPageCache(size_t capacity, DiskScheduler *disk_scheduler)
+    : capacity_(capacity), disk_scheduler_(disk_scheduler) {}
+
+auto CompressedPageCache::Put(page_id_t page_id, const char *data, bool is_dirty) -> bool {
+  char compressed[MAX_COMPRESSED_SIZE];
+  auto size = PageCompressor::Compress(data, compressed, MAX_COMPRESSED_SIZE);
+  if (size == 0 || size > capacity_) {
+    rejected_++;
+    return false;
+  }
+
+  std::vector<std::pair<page_id_t, std::string>> victims;
+  {
+    std::scoped_lock lock(latch_);
+    BUSTUB_ASSERT(entries_.count(page_id) == 0, "page is cached already");
+    while (size_ + size > capacity_) {
+      auto victim_page_id = lru_.front();
+      auto victim = entries_.find(victim_page_id);
+      size_ -= victim->second.data_.size();
+      if (victim->second.is_dirty_) {
+        writeback_pages_.insert(victim_page_id);
+        victims.emplace_back(victim_page_id, std::move(victim->second.data_));
+      }
+      entries_.erase(victim);
+      lru_.pop_front();
+      evictions_++;
+    }
+    lru_.push_back(page_id);
+    entries_.emplace(page_id, Entry{std::string(compressed, size), is_dirty, std::prev(lru_.end())});
+    size_ += size;
+  }
+  uncompressed_bytes_ += BUSTUB_PAGE_SIZE;
+  compressed_bytes_ += size;
+  WriteBack(victims);
+  return true;
+}
+
+auto CompressedPageCache::Get(page_id_t page_id, char *data, bool *is_dirty) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  // A page being written back is read from disk once written.
+  writeback_cv_.wait(lock, [this, page_id] { return writeback_pages_.count(page_id) == 0; });
+  auto entry = entries_.find(page_id);
+  if (entry == entries_.end()) {
+    misses_++;
+    return false;
+  }
+  if (!PageCompressor::Decompress(entry->second.data_.data(), entry->second.data_.size(), data)) {
+    throw Exception("corrupted page in the compressed page cache");
+  }
+  *is_dirty = entry->second.is_dirty_;
+  size_ -= entry->second.data_.size();
+  lru_.erase(entry->second.lru_pos_);
+  entries_.erase(entry);
+  hits_++;
+  return true;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  auto entry = entries_.find(page_id);
+  if (entry != entries_.end()) {
+    size_ -= entry->second.data_.size();
+    lru_.erase(entry->second.lru_pos_);
+    entries_.erase(entry);
+  }
+}
+
+auto CompressedPageCache::Flush() -> size_t {
+  std::vector<std::pair<page_id_t, std::string>> pages;
+  {
+    std::scoped_lock lock(latch_);
+    for (auto &[page_id, entry] : entries_) {
+      if (entry.is_dirty_) {
+        entry.is_dirty_ = false;
+        writeback_pages_.insert(page_id);
+        pages.emplace_back(page_id, entry.data_);
+      }
+    }
+  }
+  WriteBack(pages);
+  return pages.size();
+}
+
+void CompressedPageCache::WriteBack(const std::vector<std::pair<page_id_t, std::string>> &pages) {
+  bool corrupted = false;
+  bool failed = false;
+  for (const auto &[page_id, compressed] : pages) {
+    char data[BUSTUB_PAGE_SIZE];
+    bool write_failed = false;
+    if (PageCompressor::Decompress(compressed.data(), compressed.size(), data)) {
+      auto promise = disk_scheduler_->CreatePromise();
+      auto future = promise.get_future();
+      disk_scheduler_->Schedule({true, data, page_id, std::move(promise)});
+      write_failed = !future.get();
+      if (write_failed) {
+        failed = true;
+      } else {
+        dirty_writes_++;
+      }
+    } else {
+      corrupted = true;
+    }
+    {
+      std::scoped_lock lock(latch_);
+      writeback_pages_.erase(page_id);
+      // A page flushed but still cached stays dirty, so that a later flush tries again.
+      auto entry = entries_.find(page_id);
+      if (write_failed && entry != entries_.end()) {
+        entry->second.is_dirty_ = true;
+      }
+    }
+    writeback_cv_.notify_all();
+  }
+  if (corrupted) {
+    throw Exception("corrupted page in the compressed page cache");
+  }
+  if (failed) {
+    throw Exception("failed to write back pages of the compressed page cache");
+  }
+}
+
+void CompressedPageCache::AppendMetrics(MetricList *metrics) {
+  size_t num_pages;
+  size_t size;
+  {
+    std::scoped_lock lock(latch_);
+    num_pages = entries_.size();
+    size = size_;
+  }
+  size_t compressed_bytes = compressed_bytes_;
+  metrics->emplace_back("tier.capacity_bytes", capacity_);
+  metrics->emplace_back("tier.pages", num_pages);
+  metrics->emplace_back("tier.bytes", size);
+  metrics->emplace_back("tier.hits", hits_);
+  metrics->emplace_back("tier.misses", misses_);
+  metrics->emplace_back("tier.rejected", rejected_);
+  metrics->emplace_back("tier.evictions", evictions_);
+  metrics->emplace_back("tier.dirty_writes", dirty_writes_);
+  metrics->emplace_back("tier.compression_ratio_pct",
+                        compressed_bytes == 0 ? 0 : uncompressed_bytes_ * 100 / compressed_bytes);
+}
+
+}  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+/** Size of a huge page on the platforms we map them on. */
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static auto RoundUp(size_t size, size_t alignment) -> size_t { return (size + alignment - 1) / alignment * alignment; }
+
+FrameArena::FrameArena(size_t num_frames, bool use_huge_pages) : backing_(Backing::Pages) {
+  auto size = num_frames * BUSTUB_PAGE_SIZE;
+  void *data = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if (use_huge_pages) {
+    // Explicit huge pages have to be reserved by the administrator, most of the time there are none.
+    mapped_size_ = RoundUp(size, HUGE_PAGE_SIZE);
+    data = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      backing_ = Backing::HugeTLB;
+    }
+  }
+#endif
+
+  if (data == MAP_FAILED) {
+    mapped_size_ = RoundUp(size, BUSTUB_PAGE_SIZE);
+    data = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "can't map the frames of the buffer pool");
+    }
+#ifdef MADV_HUGEPAGE
+    // Only a hint: the kernel backs the aligned 2 MiB ranges of the region with huge pages when it can.
+    if (use_huge_pages && size >= HUGE_PAGE_SIZE && madvise(data, mapped_size_, MADV_HUGEPAGE) == 0) {
+      backing_ = Backing::TransparentHugePages;
+    }
+#endif
+  }
+
+  data_ = static_cast<char *>(data);
+  LOG_DEBUG("mapped %zu frames backed by %s", num_frames, BackingToString(backing_).c_str());
+}
+
+FrameArena::~FrameArena() { munmap(data_, mapped_size_); }
+
+auto FrameArena::Release(size_t index, size_t num_frames) -> bool {
+  // Explicit huge pages can only be released whole, madvise() rejects ranges that are not aligned to them.
+  return num_frames == 0 || madvise(FrameData(index), num_frames * BUSTUB_PAGE_SIZE, MADV_DONTNEED) == 0;
+}
+
+auto FrameArena::BackingToString(Backing backing) -> std::string {
+  switch (backing) {
+    case Backing::HugeTLB:
+      return "hugetlb";
+    case Backing::TransparentHugePages:
+      return "thp";
+    case Backing::Pages:
+      return "pages";
+  }
+  UNREACHABLE("unknown frame arena backing");
+}
+
+}  // namespace bustub
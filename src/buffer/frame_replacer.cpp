@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_replacer.cpp
+//
+// Identification: src/buffer/frame_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_pro_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t replacer_k) -> std::unique_ptr<FrameReplacer> {
+  switch (policy) {
+    case ReplacerPolicy::LRUK:
+      return std::make_unique<LRUKReplacer>(num_frames, replacer_k);
+    case ReplacerPolicy::ARC:
+      return std::make_unique<ArcReplacer>(num_frames);
+    case ReplacerPolicy::TwoQ:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacerPolicy::ClockPro:
+      return std::make_unique<ClockProReplacer>(num_frames);
+  }
+  UNREACHABLE("unknown replacer policy");
+}
+
+auto ReplacerPolicyFromString(const std::string &name) -> ReplacerPolicy {
+  auto lower = StringUtil::Lower(name);
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::ARC, ReplacerPolicy::TwoQ, ReplacerPolicy::ClockPro}) {
+    if (lower == ReplacerPolicyToString(policy)) {
+      return policy;
+    }
+  }
+  throw Exception(fmt::format("unknown replacer policy {}, expected lru_k, arc, 2q or clock_pro", name));
+}
+
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string {
+  switch (policy) {
+    case ReplacerPolicy::LRUK:
+      return "lru_k";
+    case ReplacerPolicy::ARC:
+      return "arc";
+    case ReplacerPolicy::TwoQ:
+      return "2q";
+    case ReplacerPolicy::ClockPro:
+      return "clock_pro";
+  }
+  UNREACHABLE("unknown replacer policy");
+}
+
+}  // namespace bustub
@@ -11,39 +11,59 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+#include <utility>
+
 #include "common/exception.h"
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+/** The eviction group of a frame lives in the top bits of its key, its oldest timestamp in the rest. */
+static constexpr int EVICTION_GROUP_SHIFT = 62;
+static constexpr uint64_t SCAN_ONLY_GROUP = 0;
+static constexpr uint64_t INFINITE_DISTANCE_GROUP = 1;
+static constexpr uint64_t FINITE_DISTANCE_GROUP = 2;
+
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : nodes_(num_frames), history_(num_frames * k), replacer_size_(num_frames), k_(k) {
+  BUSTUB_ENSURE(k > 0, "k must be positive");
+  heap_.reserve(num_frames);
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
   std::lock_guard<std::mutex> lock(latch_);
-  if (this->Size() == 0) {
+  if (heap_.empty()) {
     return false;
   }
 
-  *frame_id = evictable_frames_.begin()->get()->GetFid();
-  evictable_frames_.erase(evictable_frames_.begin());
-  node_store_[*frame_id]->SetIsEvictable(false);
-  node_store_[*frame_id]->ClearHistory();
-
+  *frame_id = heap_.front().frame_id_;
+  HeapErase(*frame_id);
+  ClearHistory(*frame_id);
   return true;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
   BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(replacer_size_), "Invalid frame_id");
   std::lock_guard<std::mutex> lock(latch_);
 
-  if (node_store_.count(frame_id) == 0) {
-    node_store_[frame_id] = std::make_shared<LRUKNode>(frame_id, k_);
-  } else if (node_store_[frame_id]->IsEvictable()) {
-    evictable_frames_.erase(node_store_[frame_id]);
+  auto &node = nodes_[frame_id];
+  if (access_type == AccessType::Scan) {
+    // A scan never counts as a reuse: it only refreshes frames that nothing but scans have touched.
+    if (node.history_size_ != 0 && !node.is_scan_only_) {
+      return;
+    }
+    ClearHistory(frame_id);
+    node.is_scan_only_ = true;
+  } else if (node.is_scan_only_) {
+    // Promote a scan-only frame, its scan accesses are not part of the history.
+    ClearHistory(frame_id);
   }
+  AddHistoryEntry(frame_id, current_timestamp_++);
 
-  node_store_[frame_id]->AddHistoryEntry(current_timestamp_++);
-  if (node_store_[frame_id]->IsEvictable()) {
-    evictable_frames_.insert(node_store_[frame_id]);
+  if (node.heap_index_ != INVALID_HEAP_INDEX) {
+    heap_[node.heap_index_].key_ = EvictionKey(frame_id);
+    HeapFix(node.heap_index_);
   }
 }
 
@@ -51,28 +71,141 @@ void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(replacer_size_), "Invalid frame_id");
   std::lock_guard<std::mutex> lock(latch_);
 
-  if (node_store_.count(frame_id) != 0) {
-    bool is_evictable = node_store_[frame_id]->IsEvictable();
-    node_store_[frame_id]->SetIsEvictable(set_evictable);
-
-    if (is_evictable && !set_evictable) {
-      evictable_frames_.erase(node_store_[frame_id]);
-    } else if (!is_evictable && set_evictable) {
-      evictable_frames_.insert(node_store_[frame_id]);
-    }
+  const auto &node = nodes_[frame_id];
+  if (node.history_size_ == 0) {
+    return;
+  }
+  bool is_evictable = node.heap_index_ != INVALID_HEAP_INDEX;
+  if (is_evictable && !set_evictable) {
+    HeapErase(frame_id);
+  } else if (!is_evictable && set_evictable) {
+    HeapPush(frame_id);
   }
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  std::lock_guard<std::mutex> lock(latch_);
   BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(replacer_size_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
 
-  if (node_store_.count(frame_id) != 0) {
-    BUSTUB_ENSURE(!node_store_[frame_id]->IsEvictable(), "Remove is called on a non-evictable frame");
-    evictable_frames_.erase(node_store_[frame_id]);
+  const auto &node = nodes_[frame_id];
+  if (node.history_size_ == 0) {
+    return;
   }
+  BUSTUB_ENSURE(node.heap_index_ != INVALID_HEAP_INDEX, "Remove is called on a non-evictable frame");
+  HeapErase(frame_id);
+  ClearHistory(frame_id);
 }
 
-auto LRUKReplacer::Size() -> size_t { return evictable_frames_.size(); }
+auto LRUKReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  if (heap_.empty() || max_frames == 0) {
+    return candidates;
+  }
+
+  // Walk the heap best-first: the next candidate is always the smallest entry whose parent has been taken.
+  auto greater = [this](size_t a, size_t b) { return heap_[a].key_ > heap_[b].key_; };
+  std::vector<size_t> frontier{0};
+  while (!frontier.empty() && candidates.size() < max_frames) {
+    std::pop_heap(frontier.begin(), frontier.end(), greater);
+    auto index = frontier.back();
+    frontier.pop_back();
+    candidates.push_back(heap_[index].frame_id_);
+    for (auto child : {2 * index + 1, 2 * index + 2}) {
+      if (child < heap_.size()) {
+        frontier.push_back(child);
+        std::push_heap(frontier.begin(), frontier.end(), greater);
+      }
+    }
+  }
+  return candidates;
+}
+
+auto LRUKReplacer::Size() -> size_t { return heap_.size(); }
+
+auto LRUKReplacer::EvictionKey(frame_id_t frame_id) const -> uint64_t {
+  const auto &node = nodes_[frame_id];
+  uint64_t group = FINITE_DISTANCE_GROUP;
+  if (node.is_scan_only_) {
+    group = SCAN_ONLY_GROUP;
+  } else if (node.history_size_ < k_) {
+    group = INFINITE_DISTANCE_GROUP;
+  }
+  auto oldest = (node.history_head_ + k_ - node.history_size_) % k_;
+  return (group << EVICTION_GROUP_SHIFT) | history_[frame_id * k_ + oldest];
+}
+
+void LRUKReplacer::AddHistoryEntry(frame_id_t frame_id, size_t timestamp) {
+  auto &node = nodes_[frame_id];
+  history_[frame_id * k_ + node.history_head_] = timestamp;
+  node.history_head_ = (node.history_head_ + 1) % k_;
+  if (node.history_size_ < k_) {
+    node.history_size_++;
+  }
+}
+
+void LRUKReplacer::ClearHistory(frame_id_t frame_id) {
+  auto &node = nodes_[frame_id];
+  node.history_head_ = 0;
+  node.history_size_ = 0;
+  node.is_scan_only_ = false;
+}
+
+void LRUKReplacer::HeapPush(frame_id_t frame_id) {
+  nodes_[frame_id].heap_index_ = heap_.size();
+  heap_.push_back({EvictionKey(frame_id), frame_id});
+  HeapSiftUp(heap_.size() - 1);
+}
+
+void LRUKReplacer::HeapErase(frame_id_t frame_id) {
+  auto index = nodes_[frame_id].heap_index_;
+  HeapSwap(index, heap_.size() - 1);
+  heap_.pop_back();
+  nodes_[frame_id].heap_index_ = INVALID_HEAP_INDEX;
+  if (index < heap_.size()) {
+    HeapFix(index);
+  }
+}
+
+void LRUKReplacer::HeapFix(size_t index) {
+  if (index > 0 && heap_[index].key_ < heap_[(index - 1) / 2].key_) {
+    HeapSiftUp(index);
+  } else {
+    HeapSiftDown(index);
+  }
+}
+
+void LRUKReplacer::HeapSiftUp(size_t index) {
+  while (index > 0) {
+    auto parent = (index - 1) / 2;
+    if (heap_[parent].key_ <= heap_[index].key_) {
+      return;
+    }
+    HeapSwap(index, parent);
+    index = parent;
+  }
+}
+
+void LRUKReplacer::HeapSiftDown(size_t index) {
+  while (true) {
+    auto smallest = index;
+    for (auto child : {2 * index + 1, 2 * index + 2}) {
+      if (child < heap_.size() && heap_[child].key_ < heap_[smallest].key_) {
+        smallest = child;
+      }
+    }
+    if (smallest == index) {
+      return;
+    }
+    HeapSwap(index, smallest);
+    index = smallest;
+  }
+}
+
+void LRUKReplacer::HeapSwap(size_t a, size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  nodes_[heap_[a].frame_id_].heap_index_ = a;
+  nodes_[heap_[b].frame_id_].heap_index_ = b;
+}
 
 }  // namespace bustub
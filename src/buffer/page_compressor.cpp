@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.cpp
+//
+// Identification: src/buffer/page_compressor.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_compressor.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+/** Shortest match worth a sequence, and the length of the prefixes that are hashed. */
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t HASH_BITS = 12;
+/** Length stored in a nibble of the token when more length bytes follow. */
+static constexpr size_t NIBBLE_MAX = 15;
+
+static_assert(BUSTUB_PAGE_SIZE <= UINT16_MAX, "match offsets and hash table entries are 16 bits");
+
+static auto Read32(const char *data) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static auto Hash(uint32_t value) -> size_t { return (value * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Append a sequence of literals followed by a match, or by nothing if offset is 0. */
+static auto AppendSequence(const char *literals, size_t num_literals, size_t offset, size_t match_length, char *out,
+                           size_t *out_size, size_t capacity) -> bool {
+  auto match_code = offset == 0 ? 0 : match_length - MIN_MATCH;
+  auto needed = 1 + num_literals / 255 + 1 + num_literals + (offset == 0 ? 0 : 2 + match_code / 255 + 1);
+  if (*out_size + needed > capacity) {
+    return false;
+  }
+  auto append_length = [out, out_size](size_t length) {
+    for (; length >= 255; length -= 255) {
+      out[(*out_size)++] = static_cast<char>(255);
+    }
+    out[(*out_size)++] = static_cast<char>(length);
+  };
+
+  out[(*out_size)++] =
+      static_cast<char>(std::min(num_literals, NIBBLE_MAX) << 4 | std::min<size_t>(match_code, NIBBLE_MAX));
+  if (num_literals >= NIBBLE_MAX) {
+    append_length(num_literals - NIBBLE_MAX);
+  }
+  memcpy(out + *out_size, literals, num_literals);
+  *out_size += num_literals;
+  if (offset != 0) {
+    out[(*out_size)++] = static_cast<char>(offset & 0xFF);
+    out[(*out_size)++] = static_cast<char>(offset >> 8);
+    if (match_code >= NIBBLE_MAX) {
+      append_length(match_code - NIBBLE_MAX);
+    }
+  }
+  return true;
+}
+
+auto PageCompressor::Compress(const char *page, char *out, size_t capacity) -> size_t {
+  // Position + 1 of the last prefix with each hash, 0 if none.
+  std::array<uint16_t, 1 << HASH_BITS> last_positions{};
+  size_t out_size = 0;
+  size_t literals_start = 0;
+  size_t pos = 0;
+  while (pos + MIN_MATCH <= BUSTUB_PAGE_SIZE) {
+    auto prefix = Read32(page + pos);
+    auto &last_position = last_positions[Hash(prefix)];
+    size_t candidate = last_position;
+    last_position = static_cast<uint16_t>(pos + 1);
+    if (candidate == 0 || Read32(page + candidate - 1) != prefix) {
+      ++pos;
+      continue;
+    }
+
+    auto match = candidate - 1;
+    auto match_length = MIN_MATCH;
+    while (pos + match_length < BUSTUB_PAGE_SIZE && page[match + match_length] == page[pos + match_length]) {
+      ++match_length;
+    }
+    if (!AppendSequence(page + literals_start, pos - literals_start, pos - match, match_length, out, &out_size,
+                        capacity)) {
+      return 0;
+    }
+    pos += match_length;
+    literals_start = pos;
+  }
+  if (!AppendSequence(page + literals_start, BUSTUB_PAGE_SIZE - literals_start, 0, 0, out, &out_size, capacity)) {
+    return 0;
+  }
+  return out_size;
+}
+
+auto PageCompressor::Decompress(const char *in, size_t size, char *page) -> bool {
+  size_t in_pos = 0;
+  size_t pos = 0;
+  auto read_length = [in, size, &in_pos](size_t *length) {
+    uint8_t byte;
+    do {
+      if (in_pos >= size) {
+        return false;
+      }
+      byte = static_cast<uint8_t>(in[in_pos++]);
+      *length += byte;
+    } while (byte == 255);
+    return true;
+  };
+
+  while (in_pos < size) {
+    auto token = static_cast<uint8_t>(in[in_pos++]);
+    size_t num_literals = token >> 4;
+    if (num_literals == NIBBLE_MAX && !read_length(&num_literals)) {
+      return false;
+    }
+    if (in_pos + num_literals > size || pos + num_literals > BUSTUB_PAGE_SIZE) {
+      return false;
+    }
+    memcpy(page + pos, in + in_pos, num_literals);
+    in_pos += num_literals;
+    pos += num_literals;
+    if (in_pos == size) {
+      break;
+    }
+
+    if (in_pos + 2 > size) {
+      return false;
+    }
+    size_t offset = static_cast<uint8_t>(in[in_pos]) | static_cast<size_t>(static_cast<uint8_t>(in[in_pos + 1])) << 8;
+    in_pos += 2;
+    size_t match_length = token & NIBBLE_MAX;
+    if (match_length == NIBBLE_MAX && !read_length(&match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > pos || pos + match_length > BUSTUB_PAGE_SIZE) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, e.g. a run of one byte has offset 1; copy it byte by byte.
+    for (size_t i = 0; i < match_length; ++i) {
+      page[pos + i] = page[pos - offset + i];
+    }
+    pos += match_length;
+  }
+  return pos == BUSTUB_PAGE_SIZE;
+}
+
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t max_entries) {
+  // Keep the load factor at or below one half, so that probes stay short.
+  size_t capacity = 2;
+  while (capacity < 2 * max_entries) {
+    capacity *= 2;
+  }
+  mask_ = capacity - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity);
+  for (size_t i = 0; i < capacity; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto PageTable::HomeSlot(page_id_t page_id) const -> size_t {
+  // Fibonacci hashing, page ids of a shard are strided by the number of shards.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> 32) &
+         mask_;
+}
+
+auto PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  for (size_t i = HomeSlot(page_id), probes = 0; probes <= mask_; i = (i + 1) & mask_, probes++) {
+    auto slot = slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (SlotPageId(slot) == page_id) {
+      *frame_id = SlotFrameId(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(size_ <= mask_ / 2, "page table is full");
+  auto i = HomeSlot(page_id);
+  for (auto slot = slots_[i].load(std::memory_order_relaxed); slot != EMPTY_SLOT;
+       slot = slots_[i].load(std::memory_order_relaxed)) {
+    // A second mapping would be left behind by Erase() and keep mapping the page to a frame that moved on.
+    BUSTUB_ASSERT(SlotPageId(slot) != page_id, "page is mapped already");
+    i = (i + 1) & mask_;
+  }
+  slots_[i].store(MakeSlot(page_id, frame_id), std::memory_order_release);
+  size_++;
+}
+
+auto PageTable::Erase(page_id_t page_id) -> bool {
+  auto i = HomeSlot(page_id);
+  while (true) {
+    auto slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (SlotPageId(slot) == page_id) {
+      break;
+    }
+    i = (i + 1) & mask_;
+  }
+
+  // Backward shift deletion: move back every later entry of the cluster whose probe would otherwise cross the gap, so
+  // that no tombstones are needed. Each entry is copied before its old slot is cleared.
+  auto gap = i;
+  for (auto j = (gap + 1) & mask_;; j = (j + 1) & mask_) {
+    auto slot = slots_[j].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    auto home = HomeSlot(SlotPageId(slot));
+    // The entry at j can fill the gap if its home slot is not in (gap, j], cyclically.
+    if (((j - home) & mask_) >= ((j - gap) & mask_)) {
+      slots_[gap].store(slot, std::memory_order_release);
+      gap = j;
+    }
+  }
+  slots_[gap].store(EMPTY_SLOT, std::memory_order_release);
+  size_--;
+  return true;
+}
+
+void PageTable::ForEach(const std::function<void(page_id_t, frame_id_t)> &fn) const {
+  for (size_t i = 0; i <= mask_; i++) {
+    auto slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot != EMPTY_SLOT) {
+      fn(SlotPageId(slot), SlotFrameId(slot));
+    }
+  }
+}
+
+}  // namespace bustub
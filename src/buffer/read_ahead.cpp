@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+ReadAhead::ReadAhead(BufferPoolManager *bpm, size_t max_window)
+    : bpm_(bpm), max_window_(bpm == nullptr ? 0 : std::min(max_window, std::max<size_t>(1, bpm->GetPoolSize() / 4))) {}
+
+void ReadAhead::OnPage(page_id_t page_id, page_id_t next_page_id) {
+  if (bpm_ == nullptr || page_id == last_page_id_) {
+    return;
+  }
+  bool sequential = last_page_id_ != INVALID_PAGE_ID && page_id == last_page_id_ + 1 && next_page_id == page_id + 1;
+  last_page_id_ = page_id;
+  if (next_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+
+  if (!sequential) {
+    window_ = 0;
+    if (next_page_id != hinted_end_ - 1) {
+      bpm_->PrefetchPages({next_page_id});
+      hinted_end_ = next_page_id + 1;
+    }
+    return;
+  }
+
+  // Only hint again once the scan got through half of the pages hinted so far, so that hints come in batches.
+  auto hinted_ahead = hinted_end_ > page_id ? static_cast<size_t>(hinted_end_ - page_id - 1) : 0;
+  if (window_ != 0 && hinted_ahead > window_ / 2) {
+    return;
+  }
+  window_ = window_ == 0 ? std::min(INITIAL_WINDOW, max_window_) : std::min(window_ * 2, max_window_);
+  auto begin = std::max(hinted_end_, next_page_id);
+  auto end = page_id + 1 + static_cast<page_id_t>(window_);
+  if (begin >= end) {
+    return;
+  }
+  std::vector<page_id_t> page_ids;
+  for (auto hint = begin; hint < end; hint++) {
+    page_ids.push_back(hint);
+  }
+  bpm_->PrefetchPages(page_ids);
+  hinted_end_ = end;
+}
+
+}  // namespace bustub
@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : num_frames_(num_frames),
+      max_a1in_(std::max<size_t>(1, static_cast<size_t>(static_cast<double>(num_frames) * A1IN_RATIO))),
+      max_a1out_(std::max<size_t>(1, static_cast<size_t>(static_cast<double>(num_frames) * A1OUT_RATIO))),
+      list_of_(num_frames, ListId::None),
+      position_(num_frames),
+      is_evictable_(num_frames, false),
+      page_of_(num_frames, INVALID_PAGE_ID),
+      is_ghost_hit_(num_frames, false) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (num_evictable_[static_cast<size_t>(ListId::A1In)] + num_evictable_[static_cast<size_t>(ListId::Am)] == 0) {
+    return false;
+  }
+
+  auto &list = ShouldEvictFromA1In() ? a1in_ : am_;
+  auto it = std::find_if(list.begin(), list.end(), [this](frame_id_t fid) { return is_evictable_[fid]; });
+  *frame_id = *it;
+  Untrack(*frame_id, true);
+  return true;
+}
+
+void TwoQueueReplacer::RecordLoad(frame_id_t frame_id, page_id_t page_id) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+  page_of_[frame_id] = page_id;
+  is_ghost_hit_[frame_id] = false;
+  if (auto it = a1out_index_.find(page_id); it != a1out_index_.end()) {
+    a1out_.erase(it->second);
+    a1out_index_.erase(it);
+    is_ghost_hit_[frame_id] = true;
+  }
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  auto current = list_of_[frame_id];
+  if (current == ListId::None) {
+    auto target = is_ghost_hit_[frame_id] ? ListId::Am : ListId::A1In;
+    is_ghost_hit_[frame_id] = false;
+    auto &list = ResidentList(target);
+    position_[frame_id] = list.insert(list.end(), frame_id);
+    list_of_[frame_id] = target;
+    return;
+  }
+  // Accesses to a page in A1in are considered correlated with the one that loaded it.
+  if (current == ListId::Am && access_type != AccessType::Scan) {
+    am_.splice(am_.end(), am_, position_[frame_id]);
+  }
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  auto list = list_of_[frame_id];
+  if (list == ListId::None || is_evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  is_evictable_[frame_id] = set_evictable;
+  if (set_evictable) {
+    num_evictable_[static_cast<size_t>(list)]++;
+  } else {
+    num_evictable_[static_cast<size_t>(list)]--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(num_frames_), "Invalid frame_id");
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (list_of_[frame_id] == ListId::None) {
+    return;
+  }
+  BUSTUB_ENSURE(is_evictable_[frame_id], "Remove is called on a non-evictable frame");
+  Untrack(frame_id, false);
+}
+
+auto TwoQueueReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::lock_guard<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // Assume that the queue chosen for the next eviction keeps being chosen until it runs out of evictable frames.
+  bool a1in_first = ShouldEvictFromA1In();
+  for (auto *list : {a1in_first ? &a1in_ : &am_, a1in_first ? &am_ : &a1in_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; ++it) {
+      if (is_evictable_[*it]) {
+        candidates.push_back(*it);
+      }
+    }
+  }
+  return candidates;
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> lock(latch_);
+  return num_evictable_[static_cast<size_t>(ListId::A1In)] + num_evictable_[static_cast<size_t>(ListId::Am)];
+}
+
+void TwoQueueReplacer::Untrack(frame_id_t frame_id, bool remember) {
+  auto list = list_of_[frame_id];
+  ResidentList(list).erase(position_[frame_id]);
+  if (is_evictable_[frame_id]) {
+    num_evictable_[static_cast<size_t>(list)]--;
+  }
+
+  auto page_id = page_of_[frame_id];
+  if (remember && list == ListId::A1In && page_id != INVALID_PAGE_ID) {
+    if (auto it = a1out_index_.find(page_id); it != a1out_index_.end()) {
+      a1out_.erase(it->second);
+    }
+    a1out_index_[page_id] = a1out_.insert(a1out_.end(), page_id);
+    if (a1out_.size() > max_a1out_) {
+      a1out_index_.erase(a1out_.front());
+      a1out_.pop_front();
+    }
+  }
+
+  list_of_[frame_id] = ListId::None;
+  is_evictable_[frame_id] = false;
+  page_of_[frame_id] = INVALID_PAGE_ID;
+}
+
+auto TwoQueueReplacer::ShouldEvictFromA1In() const -> bool {
+  auto a1in_evictable = num_evictable_[static_cast<size_t>(ListId::A1In)];
+  auto am_evictable = num_evictable_[static_cast<size_t>(ListId::Am)];
+  return a1in_evictable > 0 && (a1in_.size() > max_a1in_ || am_evictable == 0);
+}
+
+}  // namespace bustub
@@ -65,6 +65,9 @@ auto TableGenerator::MakeValues(ColumnInsertMeta *col_meta, uint32_t count) -> s
 void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
   uint32_t num_inserted = 0;
   uint32_t batch_size = 128;
+  // The table is loaded at once, so that only its last page is left partly empty.
+  std::vector<Tuple> tuples;
+  tuples.reserve(table_meta->num_rows_);
   while (num_inserted < table_meta->num_rows_) {
     std::vector<std::vector<Value>> values;
     uint32_t num_values = std::min(batch_size, table_meta->num_rows_ - num_inserted);
@@ -77,12 +80,11 @@ void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
       for (const auto &col : values) {
         entry.emplace_back(col[i]);
       }
-      auto rid =
-          info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple(entry, &info->schema_));
-      BUSTUB_ENSURE(rid != std::nullopt, "Sequential insertion cannot fail");
-      num_inserted++;
+      tuples.emplace_back(entry, &info->schema_);
     }
+    num_inserted += num_values;
   }
+  info->table_->BulkInsertTuples(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuples);
 }
 
 void TableGenerator::GenerateTestTables() {
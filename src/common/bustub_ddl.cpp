@@ -128,11 +128,40 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
 void BustubInstance::HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt,
                                                  ResultWriter &writer) {
   auto content = GetSessionVariable(stmt.variable_);
+  if (StringUtil::Lower(stmt.variable_) == "replacer_policy" && buffer_pool_manager_ != nullptr) {
+    content = ReplacerPolicyToString(buffer_pool_manager_->GetReplacerPolicy());
+  }
+  if (StringUtil::Lower(stmt.variable_) == "buffer_pool_size" && buffer_pool_manager_ != nullptr) {
+    content = std::to_string(buffer_pool_manager_->GetPoolSize());
+  }
+  // Progress of the buffer pool warm-up after startup, as pages gone through / pages to warm up.
+  if (StringUtil::Lower(stmt.variable_) == "warm_up_progress" && buffer_pool_manager_ != nullptr) {
+    content = fmt::format("{}/{}", buffer_pool_manager_->GetWarmedUpPageCount(),
+                          buffer_pool_manager_->GetWarmUpPageCount());
+  }
   WriteOneCell(fmt::format("{}={}", stmt.variable_, content), writer);
 }
 
 void BustubInstance::HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt,
                                                 ResultWriter &writer) {
+  // The buffer pool's replacement policy can be switched at runtime, e.g. `SET replacer_policy = 'arc'`.
+  if (StringUtil::Lower(stmt.variable_) == "replacer_policy" && buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->SetReplacerPolicy(ReplacerPolicyFromString(stmt.value_));
+  }
+  // The buffer pool can be resized online, e.g. `SET buffer_pool_size = 1024`, within its reserved capacity.
+  if (StringUtil::Lower(stmt.variable_) == "buffer_pool_size" && buffer_pool_manager_ != nullptr) {
+    size_t pool_size = 0;
+    try {
+      pool_size = std::stoull(stmt.value_);
+    } catch (std::exception &e) {
+      throw Exception(fmt::format("invalid buffer_pool_size: {}", stmt.value_));
+    }
+    if (pool_size < buffer_pool_manager_->GetNumShards() || pool_size > buffer_pool_manager_->GetMaxPoolSize()) {
+      throw Exception(fmt::format("buffer_pool_size must be between {} and {}", buffer_pool_manager_->GetNumShards(),
+                                  buffer_pool_manager_->GetMaxPoolSize()));
+    }
+    buffer_pool_manager_->Resize(pool_size);
+  }
   session_variables_[stmt.variable_] = stmt.value_;
 }
 
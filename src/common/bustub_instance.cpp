@@ -34,10 +34,14 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/table/vacuum_worker.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+/** The buffer pool can be grown up to this many frames with `SET buffer_pool_size`. */
+static constexpr size_t MAX_BUFFER_POOL_SIZE = 128 * 64;
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext> {
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
 }
@@ -54,7 +58,8 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_, 1,
+                                                 ReplacerPolicy::LRUK, true, MAX_BUFFER_POOL_SIZE);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -80,6 +85,18 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Vacuum.
+  if (buffer_pool_manager_ != nullptr) {
+    vacuum_worker_ = new VacuumWorker(catalog_, &catalog_lock_, txn_manager_);
+    vacuum_worker_->Start();
+  }
+
+  // Read back the pages that were resident when the database was closed, while queries are already served.
+  warm_up_file_name_ = db_file_name.substr(0, db_file_name.rfind('.')) + ".warmup";
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->StartWarmUp(warm_up_file_name_);
+  }
 }
 
 BustubInstance::BustubInstance() {
@@ -94,7 +111,8 @@ BustubInstance::BustubInstance() {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_, 1,
+                                                 ReplacerPolicy::LRUK, true, MAX_BUFFER_POOL_SIZE);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -120,6 +138,11 @@ BustubInstance::BustubInstance() {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Vacuum, only run with \vacuum so that the results of queries do not depend on when it runs.
+  if (buffer_pool_manager_ != nullptr) {
+    vacuum_worker_ = new VacuumWorker(catalog_, &catalog_lock_, txn_manager_);
+  }
 }
 
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
@@ -176,6 +199,8 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\stats: show buffer pool and disk statistics, also queryable as the table __buffer_pool_stats
+\vacuum: reclaim the space of deleted tuples in all tables now
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -189,6 +214,57 @@ see the execution plan of your query.
   WriteOneCell(help, writer);
 }
 
+void BustubInstance::CmdDisplayStats(ResultWriter &writer) {
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("name");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  if (buffer_pool_manager_ != nullptr) {
+    for (const auto &[name, value] : buffer_pool_manager_->GetMetrics()) {
+      writer.BeginRow();
+      writer.WriteCell(name);
+      writer.WriteCell(fmt::format("{}", value));
+      writer.EndRow();
+    }
+  }
+  if (vacuum_worker_ != nullptr) {
+    MetricList metrics;
+    vacuum_worker_->AppendMetrics(&metrics);
+    for (const auto &[name, value] : metrics) {
+      writer.BeginRow();
+      writer.WriteCell(name);
+      writer.WriteCell(fmt::format("{}", value));
+      writer.EndRow();
+    }
+  }
+  writer.EndTable();
+}
+
+void BustubInstance::CmdVacuum(ResultWriter &writer) {
+  if (vacuum_worker_ == nullptr) {
+    throw Exception("vacuum needs a buffer pool");
+  }
+  auto stats = vacuum_worker_->RunOnce();
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto *header : {"table", "pages", "compacted_pages", "reclaimed_bytes", "dead_bytes", "free_bytes"}) {
+    writer.WriteHeaderCell(header);
+  }
+  writer.EndHeader();
+  for (const auto &[table_name, table_stats] : stats) {
+    writer.BeginRow();
+    writer.WriteCell(table_name);
+    writer.WriteCell(fmt::format("{}", table_stats.num_pages_));
+    writer.WriteCell(fmt::format("{}", table_stats.num_compacted_pages_));
+    writer.WriteCell(fmt::format("{}", table_stats.reclaimed_bytes_));
+    writer.WriteCell(fmt::format("{}", table_stats.dead_bytes_));
+    writer.WriteCell(fmt::format("{}", table_stats.free_bytes_));
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 auto BustubInstance::ExecuteSql(const std::string &sql, ResultWriter &writer,
                                 std::shared_ptr<CheckOptions> check_options) -> bool {
   auto txn = txn_manager_->Begin();
@@ -220,6 +296,14 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayHelp(writer);
       return true;
     }
+    if (sql == "\\stats") {
+      CmdDisplayStats(writer);
+      return true;
+    }
+    if (sql == "\\vacuum") {
+      CmdVacuum(writer);
+      return true;
+    }
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
 
@@ -323,7 +407,7 @@ void BustubInstance::GenerateTestTable() {
   auto exec_ctx = MakeExecutorContext(txn, false);
   TableGenerator gen{exec_ctx.get()};
 
-  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  std::unique_lock<std::shared_mutex> l(catalog_lock_);
   gen.GenerateTestTables();
   l.unlock();
 
@@ -340,7 +424,7 @@ void BustubInstance::GenerateMockTable() {
   // The actual content generated by mock scan executors are described in `mock_scan_executor.cpp`.
   auto txn = txn_manager_->Begin();
 
-  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  std::unique_lock<std::shared_mutex> l(catalog_lock_);
   for (auto table_name = &mock_table_list[0]; *table_name != nullptr; table_name++) {
     catalog_->CreateTable(txn, *table_name, GetMockTableSchemaOf(*table_name), false);
   }
@@ -354,6 +438,14 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  if (!warm_up_file_name_.empty() && buffer_pool_manager_ != nullptr) {
+    try {
+      buffer_pool_manager_->DumpResidentPages(warm_up_file_name_);
+    } catch (Exception &e) {
+      // Without the file, the next startup only misses its warm-up.
+    }
+  }
+  delete vacuum_worker_;
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
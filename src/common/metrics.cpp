@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.cpp
+//
+// Identification: src/common/metrics.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bustub {
+
+auto MetricStripe() -> size_t {
+  // Threads take the stripes round-robin in the order they first record something.
+  static std::atomic<size_t> next_stripe{0};
+  thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % METRIC_STRIPES;
+  return stripe;
+}
+
+auto StripedCounter::Get() const -> uint64_t {
+  uint64_t value = 0;
+  for (const auto &stripe : stripes_) {
+    value += stripe.value_.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds duration) {
+  auto ns = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+  size_t bucket = 0;
+  while (bucket < NUM_BUCKETS - 1 && (ns >> bucket) != 0) {
+    ++bucket;
+  }
+  auto &stripe = stripes_[MetricStripe()];
+  stripe.buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  stripe.sum_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::Count() const -> uint64_t {
+  uint64_t count = 0;
+  for (const auto &stripe : stripes_) {
+    for (const auto &bucket : stripe.buckets_) {
+      count += bucket.load(std::memory_order_relaxed);
+    }
+  }
+  return count;
+}
+
+auto LatencyHistogram::Sum() const -> uint64_t {
+  uint64_t sum = 0;
+  for (const auto &stripe : stripes_) {
+    sum += stripe.sum_.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+auto LatencyHistogram::Percentile(double percentile) const -> uint64_t {
+  std::array<uint64_t, NUM_BUCKETS> counts{};
+  uint64_t count = 0;
+  for (const auto &stripe : stripes_) {
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+      auto bucket_count = stripe.buckets_[i].load(std::memory_order_relaxed);
+      counts[i] += bucket_count;
+      count += bucket_count;
+    }
+  }
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * static_cast<double>(count))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (NUM_BUCKETS - 1);
+}
+
+void LatencyHistogram::AppendTo(const std::string &name, MetricList *metrics) const {
+  auto count = Count();
+  metrics->emplace_back(name + ".count", count);
+  metrics->emplace_back(name + ".avg_us", count == 0 ? 0 : Sum() / count / 1000);
+  metrics->emplace_back(name + ".p50_us", Percentile(50) / 1000);
+  metrics->emplace_back(name + ".p99_us", Percentile(99) / 1000);
+  metrics->emplace_back(name + ".max_us", Percentile(100) / 1000);
+}
+
+}  // namespace bustub
@@ -25,6 +25,7 @@ namespace bustub {
 void TransactionManager::Commit(Transaction *txn) {
   ReleaseLocks(txn);
   txn->SetState(TransactionState::COMMITTED);
+  Finish(txn);
 }
 
 void TransactionManager::Abort(Transaction *txn) {
@@ -35,7 +36,7 @@ void TransactionManager::Abort(Transaction *txn) {
   for (auto it = revert_records->rbegin(); it != revert_records->rend(); ++it) {
     switch (it->wtype_) {
       case WType::INSERT:
-        it->table_heap_->UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, it->rid_);
+        it->table_heap_->UpdateTupleMeta({INVALID_TXN_ID, txn->GetTransactionId(), true}, it->rid_);
         break;
       case WType::DELETE:
         it->table_heap_->UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, false}, it->rid_);
@@ -47,6 +48,7 @@ void TransactionManager::Abort(Transaction *txn) {
 
   ReleaseLocks(txn);
   txn->SetState(TransactionState::ABORTED);
+  Finish(txn);
 }
 
 void TransactionManager::BlockAllTransactions() { global_txn_latch_.WLock(); }
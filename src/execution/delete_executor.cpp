@@ -40,7 +40,8 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   RID child_rid;
 
   while (child_executor_->Next(&child_tuple, &child_rid)) {
-    table_info_->table_->UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, child_rid);
+    auto delete_txn_id = txn_ != nullptr ? txn_->GetTransactionId() : INVALID_TXN_ID;
+    table_info_->table_->UpdateTupleMeta({INVALID_TXN_ID, delete_txn_id, true}, child_rid);
 
     if (txn_ != nullptr) {
       txn_->LockTxn();
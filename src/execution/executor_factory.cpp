@@ -12,7 +12,9 @@
 
 #include "execution/executor_factory.h"
 
+#include <algorithm>
 #include <memory>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "execution/executors/abstract_executor.h"
@@ -27,6 +29,7 @@
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/parallel_seq_scan_executor.h"
 #include "execution/executors/projection_executor.h"
 #include "execution/executors/seq_scan_executor.h"
 #include "execution/executors/sort_executor.h"
@@ -50,7 +53,14 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
-      return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+      auto seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan.get());
+      // Large tables are scanned on several threads.
+      auto num_workers = std::min<size_t>(std::thread::hardware_concurrency(), PARALLEL_SCAN_MAX_WORKERS);
+      auto table_info = exec_ctx->GetCatalog()->GetTable(seq_scan_plan->GetTableOid());
+      if (num_workers > 1 && table_info->table_->GetNumPages() >= PARALLEL_SCAN_MIN_PAGES) {
+        return std::make_unique<ParallelSeqScanExecutor>(exec_ctx, seq_scan_plan, num_workers);
+      }
+      return std::make_unique<SeqScanExecutor>(exec_ctx, seq_scan_plan);
     }
 
     // Create a new index scan executor
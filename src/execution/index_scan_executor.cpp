@@ -20,6 +20,9 @@ void IndexScanExecutor::Init() {
   index_info_ = exec_ctx_->GetCatalog()->GetIndex(index_oid);
   table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
   tree_ = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
+  iter_ = std::nullopt;
+  batch_.clear();
+  batch_pos_ = 0;
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -29,16 +32,23 @@ auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 
   while (true) {
-    if (iter_->IsEnd()) {
-      return false;
+    if (batch_pos_ == batch_.size()) {
+      // Read the tuples of the next INDEX_SCAN_BATCH_SIZE rids together, their pages are fetched as one batch.
+      std::vector<RID> rids;
+      for (; rids.size() < INDEX_SCAN_BATCH_SIZE && !iter_->IsEnd(); ++(*iter_)) {
+        rids.push_back((**iter_).second);
+      }
+      if (rids.empty()) {
+        return false;
+      }
+      batch_ = table_info_->table_->GetTuples(rids);
+      batch_pos_ = 0;
     }
 
-    *rid = (**iter_).second;
-    ++(*iter_);
-    auto tuple_pair = table_info_->table_->GetTuple(*rid);
-
-    if (!tuple_pair.first.is_deleted_) {
-      *tuple = std::move(tuple_pair.second);
+    auto &[meta, batch_tuple] = batch_[batch_pos_++];
+    if (!meta.is_deleted_) {
+      *rid = batch_tuple.GetRid();
+      *tuple = std::move(batch_tuple);
       return true;
     }
   }
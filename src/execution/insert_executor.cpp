@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "execution/executors/insert_executor.h"
 
@@ -49,12 +51,34 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   int insert_num = 0;
   auto table_name = table_info_->name_;
   auto indexes = exec_ctx_->GetCatalog()->GetTableIndexes(table_name);
-  Tuple child_tuple;
-  RID child_rid;
+  Tuple next_tuple;
+  RID next_rid;
 
-  while (child_executor_->Next(&child_tuple, &child_rid)) {
-    auto insert_rid = table_info_->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, child_tuple,
-                                                       exec_ctx_->GetLockManager(), txn_, plan_->TableOid());
+  // Inserts go to any page of the table with free space, where a scan of the same table below would find them again:
+  // read all the tuples to insert first.
+  std::vector<Tuple> child_tuples;
+  while (child_executor_->Next(&next_tuple, &next_rid)) {
+    child_tuples.push_back(std::move(next_tuple));
+  }
+
+  // Tuples that fill pages of their own are appended to the table at once.
+  size_t total_length = 0;
+  for (const auto &child_tuple : child_tuples) {
+    total_length += child_tuple.GetLength();
+  }
+  bool bulk_insert = total_length >= BUSTUB_PAGE_SIZE;
+  std::vector<RID> bulk_rids;
+  if (bulk_insert) {
+    bulk_rids = table_info_->table_->BulkInsertTuples(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, child_tuples,
+                                                      exec_ctx_->GetLockManager(), txn_, plan_->TableOid());
+  }
+
+  for (size_t i = 0; i < child_tuples.size(); i++) {
+    auto &child_tuple = child_tuples[i];
+    auto insert_rid = bulk_insert ? std::make_optional(bulk_rids[i])
+                                  : table_info_->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false},
+                                                                     child_tuple, exec_ctx_->GetLockManager(), txn_,
+                                                                     plan_->TableOid());
     if (insert_rid == std::nullopt) {
       continue;
     }
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <random>
 
+#include "buffer/buffer_pool_manager.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
 #include "execution/expressions/column_value_expression.h"
@@ -46,7 +47,9 @@ const char *mock_table_list[] = {"__mock_table_1", "__mock_table_2", "__mock_tab
                                  // For leaderboard Q2
                                  "__mock_t4_1m", "__mock_t5_1m", "__mock_t6_1m",
                                  // For leaderboard Q3
-                                 "__mock_t7", "__mock_t8", nullptr};
+                                 "__mock_t7", "__mock_t8",
+                                 // Statistics of the buffer pool, see BufferPoolManager::GetMetrics()
+                                 "__buffer_pool_stats", nullptr};
 
 static const int GRAPH_NODE_CNT = 10;
 
@@ -113,6 +116,10 @@ auto GetMockTableSchemaOf(const std::string &table) -> Schema {
     return Schema{std::vector{Column{"v4", TypeId::INTEGER}}};
   }
 
+  if (table == "__buffer_pool_stats") {
+    return Schema{std::vector{Column{"name", TypeId::VARCHAR, 128}, Column{"value", TypeId::BIGINT}}};
+  }
+
   throw bustub::Exception(fmt::format("mock table {} not found", table));
 }
 
@@ -399,6 +406,17 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
 
 MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan)
     : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), size_(GetSizeOf(plan)) {
+  // The statistics are a snapshot taken when the scan is created.
+  if (plan->GetTable() == "__buffer_pool_stats" && exec_ctx->GetBufferPoolManager() != nullptr) {
+    metrics_ = exec_ctx->GetBufferPoolManager()->GetMetrics();
+    size_ = metrics_.size();
+    func_ = [this](size_t cursor) {
+      std::vector<Value> values{};
+      values.push_back(ValueFactory::GetVarcharValue(metrics_[cursor].first));
+      values.push_back(ValueFactory::GetBigIntValue(static_cast<int64_t>(metrics_[cursor].second)));
+      return Tuple{values, &plan_->OutputSchema()};
+    };
+  }
   if (GetShuffled(plan)) {
     for (size_t i = 0; i < size_; i++) {
       shuffled_idx_.push_back(i);
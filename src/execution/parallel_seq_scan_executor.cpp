@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_seq_scan_executor.cpp
+//
+// Identification: src/execution/parallel_seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/parallel_seq_scan_executor.h"
+
+#include <utility>
+
+namespace bustub {
+
+ParallelSeqScanExecutor::ParallelSeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan,
+                                                 size_t num_workers)
+    : SeqScanExecutor(exec_ctx, plan), num_workers_(num_workers) {
+  BUSTUB_ENSURE(num_workers_ > 0, "a parallel scan needs workers");
+}
+
+ParallelSeqScanExecutor::~ParallelSeqScanExecutor() { StopWorkers(); }
+
+void ParallelSeqScanExecutor::Init() {
+  SeqScanExecutor::Init();
+  {
+    // Init() is called again to rescan, e.g. by a nested loop join. The workers are kept, the ones still reading a
+    // morsel of the previous scan drop it once read.
+    std::scoped_lock lock(latch_);
+    scan_++;
+    morsels_.clear();
+    batches_.clear();
+    error_ = nullptr;
+  }
+  next_dispatch_seq_ = 0;
+  next_gather_seq_ = 0;
+  if (workers_.empty()) {
+    for (size_t i = 0; i < num_workers_; i++) {
+      workers_.emplace_back([this] { Work(); });
+    }
+  }
+}
+
+auto ParallelSeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (batch_pos_ == batch_.size()) {
+    Dispatch();
+    if (next_gather_seq_ == next_dispatch_seq_) {
+      FinishScan();
+      return false;
+    }
+
+    std::unique_lock lock(latch_);
+    batch_cv_.wait(lock, [&] { return error_ != nullptr || batches_.count(next_gather_seq_) > 0; });
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+    auto batch = batches_.find(next_gather_seq_++);
+    batch_ = std::move(batch->second);
+    batch_pos_ = 0;
+    batches_.erase(batch);
+  }
+
+  *tuple = std::move(batch_[batch_pos_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+void ParallelSeqScanExecutor::Dispatch() {
+  while (!it_->IsEnd() && next_dispatch_seq_ - next_gather_seq_ < num_workers_ * MORSELS_PER_WORKER) {
+    auto max_tuples = LockPage();
+    auto iter = it_->SplitPage(max_tuples);
+    {
+      std::scoped_lock lock(latch_);
+      morsels_.push_back(Morsel{scan_, next_dispatch_seq_++, std::move(iter)});
+    }
+    morsel_cv_.notify_one();
+  }
+}
+
+void ParallelSeqScanExecutor::Work() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    morsel_cv_.wait(lock, [&] { return stopped_ || !morsels_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    auto morsel = std::move(morsels_.front());
+    morsels_.pop_front();
+    lock.unlock();
+
+    std::vector<Tuple> batch;
+    std::exception_ptr error;
+    try {
+      while (!morsel.iter_.IsEnd()) {
+        morsel.iter_.NextPage(filter_, &batch);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    if (morsel.scan_ != scan_) {
+      continue;
+    }
+    if (error != nullptr) {
+      error_ = error;
+    }
+    batches_.emplace(morsel.seq_, std::move(batch));
+    batch_cv_.notify_one();
+  }
+}
+
+void ParallelSeqScanExecutor::StopWorkers() {
+  {
+    std::scoped_lock lock(latch_);
+    stopped_ = true;
+  }
+  morsel_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+}  // namespace bustub
@@ -12,11 +12,24 @@
 
 #include "execution/executors/seq_scan_executor.h"
 
+#include <limits>
+
 namespace bustub {
 
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {
   txn_ = exec_ctx_->GetTransaction();
+  // The filter is checked in place, only the tuples that pass are copied out.
+  filter_ = [this](const TupleMeta &meta, const TupleView &view) {
+    if (meta.is_deleted_) {
+      return false;
+    }
+    if (plan_->filter_predicate_ == nullptr) {
+      return true;
+    }
+    auto value = plan_->filter_predicate_->EvaluateView(view, GetOutputSchema());
+    return !value.IsNull() && value.GetAs<bool>();
+  };
 }
 
 void SeqScanExecutor::Init() {
@@ -24,6 +37,8 @@ void SeqScanExecutor::Init() {
   auto info = exec_ctx_->GetCatalog()->GetTable(table_oid);
   auto tmp_it = info->table_->MakeIterator();
   it_.emplace(std::move(tmp_it));
+  batch_.clear();
+  batch_pos_ = 0;
 
   if (txn_ != nullptr) {
     if (exec_ctx_->IsDelete()) {
@@ -39,49 +54,54 @@ void SeqScanExecutor::Init() {
 }
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  while (true) {
-    auto oid = plan_->GetTableOid();
+  while (batch_pos_ == batch_.size()) {
     if (it_->IsEnd()) {
-      if (txn_ != nullptr && txn_->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
-          txn_->IsTableIntentionSharedLocked(oid)) {
-        txn_->LockTxn();
-        auto release_set = (*txn_->GetSharedRowLockSet())[oid];
-        txn_->UnlockTxn();
-        for (auto locked_rid : release_set) {
-          exec_ctx_->GetLockManager()->UnlockRow(txn_, oid, locked_rid);
-        }
-
-        exec_ctx_->GetLockManager()->UnlockTable(txn_, oid);
-      }
+      FinishScan();
       return false;
     }
+    auto max_tuples = LockPage();
+    batch_.clear();
+    batch_pos_ = 0;
+    it_->NextPage(filter_, &batch_, max_tuples);
+  }
 
-    auto cur_rid = it_->GetRID();
-    if (txn_ != nullptr) {
-      if (exec_ctx_->IsDelete()) {
-        if (!exec_ctx_->GetLockManager()->LockRow(txn_, LockManager::LockMode::EXCLUSIVE, plan_->GetTableOid(),
-                                                  cur_rid)) {
-          throw ExecutionException("Grant X row lock fails");
-        }
-      } else {
-        if (txn_->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
-          if (!txn_->IsRowExclusiveLocked(oid, cur_rid) &&
-              !exec_ctx_->GetLockManager()->LockRow(txn_, LockManager::LockMode::SHARED, plan_->GetTableOid(),
-                                                    cur_rid)) {
-            throw ExecutionException("Grant S row lock fails");
-          }
-        }
+  *tuple = std::move(batch_[batch_pos_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+auto SeqScanExecutor::LockPage() -> size_t {
+  if (txn_ == nullptr || (!exec_ctx_->IsDelete() && txn_->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED)) {
+    return std::numeric_limits<size_t>::max();
+  }
+  auto oid = plan_->GetTableOid();
+  auto rids = it_->GetPageRIDs();
+  for (const auto &cur_rid : rids) {
+    if (exec_ctx_->IsDelete()) {
+      if (!exec_ctx_->GetLockManager()->LockRow(txn_, LockManager::LockMode::EXCLUSIVE, oid, cur_rid)) {
+        throw ExecutionException("Grant X row lock fails");
       }
+    } else if (!txn_->IsRowExclusiveLocked(oid, cur_rid) &&
+               !exec_ctx_->GetLockManager()->LockRow(txn_, LockManager::LockMode::SHARED, oid, cur_rid)) {
+      throw ExecutionException("Grant S row lock fails");
     }
+  }
+  return rids.size();
+}
 
-    auto tuple_pair = it_->GetTuple();
-    ++(*it_);
-    if (!tuple_pair.first.is_deleted_) {
-      *tuple = tuple_pair.second;
-      *rid = tuple_pair.second.GetRid();
-      return true;
+void SeqScanExecutor::FinishScan() {
+  auto oid = plan_->GetTableOid();
+  if (txn_ != nullptr && txn_->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
+      txn_->IsTableIntentionSharedLocked(oid)) {
+    txn_->LockTxn();
+    auto release_set = (*txn_->GetSharedRowLockSet())[oid];
+    txn_->UnlockTxn();
+    for (auto locked_rid : release_set) {
+      exec_ctx_->GetLockManager()->UnlockRow(txn_, oid, locked_rid);
     }
+
+    exec_ctx_->GetLockManager()->UnlockTable(txn_, oid);
   }
 }
 
-}  // namespace bustub
\ No newline at end of file
+}  // namespace bustub
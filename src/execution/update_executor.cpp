@@ -34,12 +34,19 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   }
 
   int modified_num = 0;
-  Tuple child_tuple;
-  RID child_rid;
+  Tuple next_tuple;
+  RID next_rid;
   auto table_name = table_info_->name_;
   std::vector<IndexInfo *> indexes = exec_ctx_->GetCatalog()->GetTableIndexes(table_name);
 
-  while (child_executor_->Next(&child_tuple, &child_rid)) {
+  // New versions go to any page of the table with free space, where the scan below would find them again: read all
+  // the tuples to update first.
+  std::vector<std::pair<Tuple, RID>> child_tuples;
+  while (child_executor_->Next(&next_tuple, &next_rid)) {
+    child_tuples.emplace_back(std::move(next_tuple), next_rid);
+  }
+
+  for (auto &[child_tuple, child_rid] : child_tuples) {
     std::vector<Value> values{};
     values.reserve(table_info_->schema_.GetColumnCount());
 
@@ -48,7 +55,9 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     }
 
     Tuple new_tuple = {values, &child_executor_->GetOutputSchema()};
-    table_info_->table_->UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, child_rid);
+    auto *txn = exec_ctx_->GetTransaction();
+    auto delete_txn_id = txn != nullptr ? txn->GetTransactionId() : INVALID_TXN_ID;
+    table_info_->table_->UpdateTupleMeta({INVALID_TXN_ID, delete_txn_id, true}, child_rid);
     auto new_rid = table_info_->table_->InsertTuple({INVALID_TXN_ID, INVALID_TXN_ID, false}, new_tuple);
     BUSTUB_ASSERT(new_rid.has_value(), "insert tuple fails when update");
 
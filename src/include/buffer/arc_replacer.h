@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/frame_replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ArcReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST '03).
+ *
+ * Resident frames are kept in two LRU lists: T1 holds pages accessed once since they were loaded, T2 pages accessed
+ * at least twice. The pages of frames evicted from T1 and T2 are remembered in the ghost lists B1 and B2. A page
+ * that is loaded again while in B1 shows that T1 is too small and grows the target size of T1, one that is in B2
+ * shrinks it, and either way the page goes straight to T2. Evictions take the LRU evictable frame of T1 while T1 is
+ * above its target, and of T2 otherwise.
+ *
+ * Scan accesses never move a frame to T2.
+ */
+class ArcReplacer : public FrameReplacer {
+ public:
+  /** @param num_frames the maximum number of frames the replacer will be required to store */
+  explicit ArcReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ArcReplacer);
+
+  ~ArcReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+  void RecordLoad(frame_id_t frame_id, page_id_t page_id) override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+  void Remove(frame_id_t frame_id) override;
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+  auto Size() -> size_t override;
+
+ private:
+  enum class ListId { None = 0, T1, T2 };
+
+  /** Stop tracking the frame, remembering its page in the ghost list matching its list if remember is set. */
+  void Untrack(frame_id_t frame_id, bool remember);
+  /** Trim the ghost lists to |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+  /** @return true if the next victim should come from T1 */
+  auto ShouldEvictFromT1() const -> bool;
+  auto ResidentList(ListId list) -> std::list<frame_id_t> & { return list == ListId::T1 ? t1_ : t2_; }
+
+  const size_t num_frames_;
+  /** Resident frames, least recently used first. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  /** Pages of frames evicted from T1 and T2, least recently evicted first. */
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> b1_index_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> b2_index_;
+  /** Target size of T1, adapted on ghost hits. */
+  size_t target_t1_{0};
+
+  /** Per-frame state, indexed by frame id. */
+  std::vector<ListId> list_of_;
+  std::vector<std::list<frame_id_t>::iterator> position_;
+  std::vector<bool> is_evictable_;
+  std::vector<page_id_t> page_of_;
+  /** Set by RecordLoad() for a page found in a ghost list, the frame starts in T2. */
+  std::vector<bool> is_ghost_hit_;
+  /** Number of evictable frames in T1 and T2, indexed by ListId. */
+  size_t num_evictable_[3]{};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
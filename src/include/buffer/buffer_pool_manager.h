@@ -12,15 +12,29 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
 #include <list>
 #include <memory>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
 
-#include "buffer/lru_k_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/frame_replacer.h"
+#include "buffer/page_table.h"
 #include "common/config.h"
+#include "common/metrics.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
@@ -28,6 +42,33 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * The frames of the pool are split into one or more shards. Every shard owns a contiguous range of frames together
+ * with its own page table, free list, replacer and latch, and a page always lives in the shard selected by
+ * `page_id % num_shards`. Operations on pages of different shards therefore never contend on the same latch.
+ *
+ * Hits don't take the shard latch: the page table can be read without a lock and pin counts are atomic. A hit looks the
+ * page up, pins its frame unless the frame is being taken for another page (pin count -1), and checks that the frame
+ * still holds the page. The replacer learns about such hits in batches, see RecordHit(), and a frame it picks as a
+ * victim is only evicted if its pin count can go from 0 to -1; a frame found pinned is tracked again as just accessed.
+ *
+ * Disk I/O is never performed while holding a shard latch. A miss reserves its frame in the "I/O pending" state,
+ * drops the latch to write back the victim and read the page, and concurrent fetchers of the same page wait on that
+ * frame rather than on the whole shard.
+ *
+ * All page reads and writes go through a DiskScheduler, whose worker threads perform them on the disk manager.
+ *
+ * The data of all frames lives in one FrameArena, the page metadata in a separate array.
+ *
+ * The replacement policy is chosen per pool, see ReplacerPolicy, and can be switched while the pool is in use.
+ *
+ * Scans can hint the pages they are about to fetch with PrefetchPages(), a read-ahead thread then reads them into the
+ * pool in the background.
+ *
+ * The pool can be resized while in use, see Resize(), up to the capacity it was created with.
+ *
+ * The resident pages can be saved with DumpResidentPages() and read back by StartWarmUp() after a restart, so that the
+ * pool does not have to refill one miss at a time.
  */
 class BufferPoolManager {
  public:
@@ -37,9 +78,18 @@ class BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param num_shards the number of partitions the frames are split into, each with its own latch
+   * @param replacer_policy the replacement policy of the pool
+   * @param use_huge_pages whether to back the frames with huge pages when the platform allows it
+   * @param max_pool_size the size the pool can grow to with Resize(), 0 for pool_size. The address space of that many
+   * frames is reserved up front, memory is only used by the frames in use.
+   * @param compressed_cache_size the capacity in bytes of a CompressedPageCache between the pool and the disk, 0 for
+   * none. Evicted pages are compressed into it, and misses that find their page there do not read the disk.
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, size_t num_shards = 1,
+                    ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK, bool use_huge_pages = true,
+                    size_t max_pool_size = 0, size_t compressed_cache_size = 0);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
@@ -49,17 +99,156 @@ class BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
+  /** @brief Return the largest size the buffer pool can be resized to. */
+  auto GetMaxPoolSize() const -> size_t { return max_pool_size_; }
+
+  /**
+   * @brief Grow or shrink the buffer pool to pool_size frames.
+   *
+   * Every shard gets its share of the new size. Growing hands the new frames to the free lists right away. Shrinking
+   * takes the frames at the end of each shard out of use: free ones at once, resident ones once they are unpinned,
+   * writing back the dirty ones. The shard latch is only held while looking at the frames and never during the
+   * write-backs, so fetches keep going; Resize() itself returns once every frame is drained, and the memory of the
+   * drained frames is given back to the operating system. Concurrent calls are serialized.
+   *
+   * A shard whose frames are still pinned when the timeout runs out keeps the frames up to its last pinned one, and
+   * GetPoolSize() reports the size the pool got to.
+   *
+   * @param pool_size the new number of frames, at least the number of shards and at most GetMaxPoolSize()
+   * @param timeout how long shrinking waits for pinned frames
+   * @throws Exception if the pool could not be shrunk to pool_size in time
+   */
+  void Resize(size_t pool_size, std::chrono::milliseconds timeout = BUFFER_POOL_RESIZE_TIMEOUT);
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
-  auto GetAvailablePage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page *;
+  /** @brief Return how the memory of the frames is backed. */
+  auto GetFrameArenaBacking() const -> FrameArena::Backing { return frame_arena_->GetBacking(); }
+
+  /** @brief Return the number of shards the buffer pool is partitioned into. */
+  auto GetNumShards() -> size_t { return shards_.size(); }
+
+  /** @brief Return the replacement policy the pool is running with. */
+  auto GetReplacerPolicy() const -> ReplacerPolicy { return replacer_policy_; }
+
+  /**
+   * @brief Switch the pool to another replacement policy.
+   *
+   * Each shard gets a new replacer that starts out tracking the resident pages with no access history, pinned pages
+   * stay non-evictable.
+   */
+  void SetReplacerPolicy(ReplacerPolicy replacer_policy);
+
+  /** @brief Return the number of evictions whose victim frame was clean, so no write-back was needed. */
+  auto GetCleanEvictionCount() const -> size_t { return clean_evictions_; }
+
+  /** @brief Return the number of evictions that had to write back a dirty victim frame. */
+  auto GetDirtyEvictionCount() const -> size_t { return dirty_evictions_; }
+
+  /** @brief Return the number of FetchPage() calls of the given access type that found the page in the pool. */
+  auto GetHitCount(AccessType access_type) -> size_t;
+
+  /** @brief Return the number of FetchPage() calls of the given access type that had to read the page from disk. */
+  auto GetMissCount(AccessType access_type) -> size_t;
+
+  /** @brief Return the number of pages written back by the background writer. */
+  auto GetBackgroundWriteCount() const -> size_t { return background_writes_; }
+
+  /** @brief Return the number of pages read into the pool by PrefetchPages(). */
+  auto GetPrefetchCount() const -> size_t { return prefetch_count_; }
+
+  /** @brief Return the time FetchPage() calls spent waiting for the I/O of another thread on their page. */
+  auto GetPinWaitLatency() const -> const LatencyHistogram & { return pin_wait_latency_; }
+
+  /** @brief Return the time FetchPage() calls that missed took, eviction and read included. */
+  auto GetMissLatency() const -> const LatencyHistogram & { return miss_latency_; }
+
+  /**
+   * @brief Return a snapshot of the statistics of the pool, its replacers, and the disk I/O it performs.
+   *
+   * Metrics are named component.metric, e.g. bpm.hits.get, replacer.pinned_victims or disk.read; latency histograms
+   * are reported as several metrics, see LatencyHistogram::AppendTo(). The counters are read one at a time while the
+   * pool keeps running, so they are not exactly consistent with each other.
+   */
+  auto GetMetrics() -> MetricList;
+
+  /**
+   * @brief Hint that the given pages are about to be fetched, e.g. by a sequential scan.
+   *
+   * Returns right away. The read-ahead thread, started on the first call, reads the pages that are not in the pool yet
+   * into frames that are evicted like pages fetched with AccessType::Scan, scheduling all the reads of a hint at once.
+   * A page read ahead stays pinned until it is fetched, so that the scan does not evict its own read-ahead; at most a
+   * quarter of the pool is held that way, the pages read ahead the longest ago are released first. Pages that were
+   * never allocated, and pages that would need a dirty victim written back first, are skipped. Fetching a page while it
+   * is being read ahead waits for the read like any other fetch.
+   *
+   * @param page_ids the pages to read ahead, in the order they will be fetched
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids);
+
+  /**
+   * @brief Start a background writer thread that trickles dirty pages to disk ahead of eviction.
+   *
+   * Every interval, the writer looks at the first target_clean_ratio of each shard's frames in the replacer's
+   * eviction order (free frames count as clean) and writes back the dirty ones, so that the next evictions find a
+   * clean victim and misses don't wait for a write-back. Does nothing if the writer is already running.
+   *
+   * @param target_clean_ratio fraction of each shard's frames that should be clean and next in line for eviction
+   * @param interval time between two rounds of the writer
+   */
+  void StartBackgroundWriter(double target_clean_ratio = 0.25,
+                             std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+
+  /** @brief Stop the background writer thread, if running. */
+  void StopBackgroundWriter();
 
-  auto FlushPageCommon(page_id_t page_id) -> bool;
+  /**
+   * @brief Save the ids of the resident pages to a file, hottest first, for StartWarmUp() to read them back.
+   *
+   * The heat of a page is its position in the replacer's eviction order, scaled to (0, 1] within its shard; pinned
+   * pages get a heat of 1.
+   *
+   * @param path the file to write, replaced if it exists
+   * @return the number of pages saved
+   */
+  auto DumpResidentPages(const std::string &path) -> size_t;
+
+  /**
+   * @brief Start reading the pages saved by DumpResidentPages() into the pool, in the background.
+   *
+   * Returns right away, queries can be served while the pool warms up. A warm-up thread reads the pages that are still
+   * allocated, at most one pool full, hottest first, in batches of WARM_UP_BATCH_SIZE pages sorted by page id and read
+   * with a single round of I/O. Warm-up only fills free frames and never evicts, pages fetched by queries in the
+   * meantime take precedence. Pages warmed up are evicted like pages fetched with AccessType::Scan until a query
+   * fetches them. Waits for a previous warm-up to finish first.
+   *
+   * @param path the file written by DumpResidentPages()
+   * @return the number of pages to warm up, 0 if the file can't be read
+   */
+  auto StartWarmUp(const std::string &path) -> size_t;
+
+  /** @brief Wait until the warm-up started by StartWarmUp(), if any, is done. */
+  void WaitForWarmUp();
+
+  /** @brief Return the number of pages the last StartWarmUp() set out to read. */
+  auto GetWarmUpPageCount() const -> size_t { return warm_up_pages_; }
+
+  /**
+   * @brief Return the number of pages the warm-up has gone through so far, including those skipped because they were
+   * resident already or the shard had no free frame left. Equal to GetWarmUpPageCount() once the warm-up is done.
+   */
+  auto GetWarmedUpPageCount() const -> size_t { return warmed_up_pages_; }
 
   /**
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
    * are currently in use and not evictable (in another word, pinned).
    *
+   * Shards are tried round-robin, and the new page id is allocated from the first shard that has a frame available.
+   * Page ids are therefore not handed out in increasing order: a shard that is skipped because all of its frames are
+   * pinned falls behind the others, and freed page ids are reused lowest first. Callers must not infer the order in
+   * which pages were created, e.g. their position in a page chain, from their ids.
+   *
    * You should pick the replacement frame from either the free list or the replacer (always find from the free list
    * first), and then call the AllocatePage() method to get a new page id. If the replacement frame has a dirty page,
    * you should write it back to the disk first. You also need to reset the memory and metadata for the new page.
@@ -87,7 +276,9 @@ class BufferPoolManager {
 
   /**
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
-   * but all frames are currently in use and not evictable (in another word, pinned).
+   * but all frames are currently in use and not evictable (in another word, pinned), if page_id is not allocated,
+   * e.g. because the page was deleted since the caller read its id, or if reading the page or writing back the dirty
+   * victim failed.
    *
    * First search for page_id in the buffer pool. If not found, pick a replacement frame from either the free list or
    * the replacer (always find from the free list first), read the page from disk by calling disk_manager_->ReadPage(),
@@ -97,7 +288,8 @@ class BufferPoolManager {
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
    * @param page_id id of page to be fetched
-   * @param access_type type of access to the page, only needed for leaderboard tests.
+   * @param access_type type of access to the page. Pages fetched with AccessType::Scan are evicted before the
+   * pages accessed otherwise, so that a large scan does not flush the working set out of the pool.
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
   auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
@@ -111,11 +303,57 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page, AccessType::Scan for sequential scans
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
+
+  /**
+   * @brief PageGuard wrapper for FetchPage that does not latch the page.
+   *
+   * The returned guard keeps the page pinned and remembers its version, the caller reads the page without any latch
+   * and calls Validate() on the guard to find out whether a writer got in the way. See OptimisticReadPageGuard.
+   *
+   * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page
+   * @return OptimisticReadPageGuard holding the fetched page
+   */
+  auto FetchPageOptimistic(page_id_t page_id, AccessType access_type = AccessType::Unknown)
+      -> OptimisticReadPageGuard;
+
+  /**
+   * @brief Fetch several pages at once, e.g. the pages of a batch of RIDs returned by an index scan.
+   *
+   * Pages that are resident are pinned without the shard latch, the others are looked up with each shard's latch
+   * taken once for the whole batch. A frame is reserved for every miss, then all the reads are scheduled on the disk
+   * scheduler as a single batch and waited for together.
+   *
+   * @param page_ids the pages to fetch, may contain duplicates, each of which pins the page once more
+   * @param access_type type of access to the pages
+   * @return the fetched pages, in the order of page_ids; nullptr for the pages that could not be fetched, see
+   * FetchPage()
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *>;
+
+  /**
+   * @brief PageGuard wrappers for FetchPages
+   *
+   * The pages are latched in the order of page_ids once all of them are in the pool. To avoid deadlocks, callers that
+   * latch several pages should pass them in a consistent order, e.g. sorted by page id, and without duplicates.
+   *
+   * @param page_ids the pages to fetch
+   * @param access_type type of access to the pages
+   * @return a PageGuard for every page, in the order of page_ids; a guard holding no page if it could not be fetched
+   */
+  auto FetchPagesBasic(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<BasicPageGuard>;
+  auto FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<ReadPageGuard>;
+  auto FetchPagesWrite(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<WritePageGuard>;
 
   /**
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
@@ -134,26 +372,27 @@ class BufferPoolManager {
   /**
    * @brief Flush the target page to disk.
    *
-   * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
+   * Schedule a write of the page on the disk scheduler and wait for it, REGARDLESS of the dirty flag.
    * Unset the dirty flag of the page after flushing.
    *
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
-   * @return false if the page could not be found in the page table, true otherwise
+   * @return false if the page could not be found in the page table or the write failed, true otherwise
    */
   auto FlushPage(page_id_t page_id) -> bool;
 
   /**
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the pages in the buffer pool to disk. The writes of all pages are scheduled together, so that
+   * the disk scheduler can merge adjacent pages.
    */
   void FlushAllPages();
 
   /**
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Delete a page from the buffer pool and deallocate it on disk. If the page is pinned and cannot be deleted,
+   * return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-   * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * back to the free list. Also, reset the page's memory and metadata. Finally, the page is deallocated on disk, also
+   * if it was not in the buffer pool, and NewPage() reuses its id later.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
@@ -161,38 +400,266 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
+  /** Number of hits a shard buffers before handing them to its replacer. */
+  static constexpr size_t ACCESS_BUFFER_SIZE = 64;
+  /** Number of pages the warm-up reads with one round of I/O. */
+  static constexpr size_t WARM_UP_BATCH_SIZE = 256;
+
+  /**
+   * A partition of the buffer pool. Frames [frame_offset_, frame_offset_ + num_frames_) belong to this shard and
+   * are only ever used for pages whose id maps to it. The frames up to frame_offset_ + max_frames_ are reserved for
+   * the shard to grow into.
+   */
+  struct Shard {
+    Shard(size_t index, frame_id_t frame_offset, size_t num_frames, size_t max_frames,
+          ReplacerPolicy replacer_policy, size_t replacer_k)
+        : index_(index),
+          frame_offset_(frame_offset),
+          max_frames_(max_frames),
+          num_frames_(num_frames),
+          page_table_(max_frames),
+          replacer_(MakeReplacer(replacer_policy, max_frames, replacer_k)) {}
+
+    /** Position of the shard, the shard holds the pages with page_id % number of shards == index_. */
+    const size_t index_;
+    /** Id of the first frame owned by this shard. */
+    const frame_id_t frame_offset_;
+    /** Number of frames reserved for this shard, the replacer and page table are sized for all of them. */
+    const size_t max_frames_;
+    /** Number of frames in use by this shard, protected by latch_. */
+    size_t num_frames_;
+    /** Page table for keeping track of the pages of this shard, readable without the latch. */
+    PageTable page_table_;
+    /** Replacer to find unpinned pages for replacement, indexed by frame id relative to frame_offset_. */
+    std::unique_ptr<FrameReplacer> replacer_;
+    /** List of free frames that don't have any pages on them. */
+    std::list<frame_id_t> free_list_;
+    /** Evicted dirty pages whose write-back is still in flight; they must not be read from disk until it completes. */
+    std::unordered_set<page_id_t> writeback_pages_;
+    /**
+     * Protects the updates of page_table_, replacer_, free_list_ and writeback_pages_, and taking a frame for another
+     * page.
+     */
+    std::mutex latch_;
+    /** Signalled whenever a frame of this shard finishes its pending I/O. */
+    std::condition_variable io_cv_;
+    /** Accesses of hits that the replacer has not been told about yet, 0 for an empty slot. See RecordHit(). */
+    std::array<std::atomic<uint64_t>, ACCESS_BUFFER_SIZE> access_buffer_{};
+    /** Slot of access_buffer_ that the next hit is recorded in, modulo ACCESS_BUFFER_SIZE. */
+    std::atomic<size_t> access_buffer_next_{0};
+    /** FetchPage() hits and misses, indexed by AccessType. */
+    std::array<StripedCounter, NUM_ACCESS_TYPES> hits_;
+    std::array<StripedCounter, NUM_ACCESS_TYPES> misses_;
+  };
+
   /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
+  std::atomic<size_t> pool_size_;
+  /** Number of frames reserved, see GetMaxPoolSize(). */
+  const size_t max_pool_size_;
+  /** Serializes Resize() calls. */
+  std::mutex resize_latch_;
+  /** The lookback constant k of LRU-K replacers. */
+  const size_t replacer_k_;
+  /** The replacement policy of every shard. */
+  std::atomic<ReplacerPolicy> replacer_policy_;
+  /** Shard that the next NewPage() call starts probing from. */
+  std::atomic<size_t> next_new_shard_ = 0;
 
-  /** Array of buffer pool pages. */
+  /** The data of the frames. */
+  std::unique_ptr<FrameArena> frame_arena_;
+  /** Array of buffer pool pages, the metadata of the frames. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
+  /** Performs the disk I/O of the pool in the background. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
+  /** Second tier of pages evicted from the pool, nullptr if disabled. */
+  std::unique_ptr<CompressedPageCache> compressed_cache_;
+
+  /** Eviction statistics, see GetCleanEvictionCount() and GetDirtyEvictionCount(). */
+  std::atomic<size_t> clean_evictions_ = 0;
+  std::atomic<size_t> dirty_evictions_ = 0;
+  std::atomic<size_t> background_writes_ = 0;
+
+  /** The background writer thread, joinable while it runs. */
+  std::thread bg_writer_;
+  /** Protects bg_writer_stop_. */
+  std::mutex bg_writer_latch_;
+  /** Signalled to stop the background writer. */
+  std::condition_variable bg_writer_cv_;
+  bool bg_writer_stop_ = false;
+
+  /** See GetPinWaitLatency() and GetMissLatency(). */
+  LatencyHistogram pin_wait_latency_;
+  LatencyHistogram miss_latency_;
+  /** Victims picked by the replacers that turned out to be pinned by a hit, and had to be passed over. */
+  StripedCounter replacer_pinned_victims_;
+  /** Hits without the shard latch that were handed to the replacers, the others were lost. See RecordHit(). */
+  StripedCounter replacer_sampled_hits_;
+
+  /** Pages read ahead, see GetPrefetchCount(). */
+  std::atomic<size_t> prefetch_count_ = 0;
+  /** The read-ahead thread, joinable once the first hint has been given. */
+  std::thread read_ahead_thread_;
+  /** Protects read_ahead_queue_, read_ahead_stop_ and the start of read_ahead_thread_. */
+  std::mutex read_ahead_latch_;
+  /** Signalled when pages are hinted or the read-ahead thread has to stop. */
+  std::condition_variable read_ahead_cv_;
+  /** Hinted pages the read-ahead thread has not looked at yet. */
+  std::deque<page_id_t> read_ahead_queue_;
+  /** Pages read ahead, oldest first, that may still hold their pin. Only used by the read-ahead thread. */
+  std::deque<page_id_t> read_ahead_pinned_;
+  bool read_ahead_stop_ = false;
+
+  /** The warm-up thread, joinable once a warm-up has been started. */
+  std::thread warm_up_thread_;
+  /** Warm-up progress, see GetWarmUpPageCount() and GetWarmedUpPageCount(). */
+  std::atomic<size_t> warm_up_pages_ = 0;
+  std::atomic<size_t> warmed_up_pages_ = 0;
+  /** Set to abandon the warm-up. */
+  std::atomic<bool> warm_up_stop_ = false;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** Partitions of the buffer pool. */
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  /** @return the shard that the given page lives in */
+  auto ShardOf(page_id_t page_id) -> Shard & { return *shards_[static_cast<size_t>(page_id) % shards_.size()]; }
+
+  /**
+   * @brief Schedule a read or write of one page on the disk scheduler.
+   * @param data the frame's data, must stay valid until the returned future is ready
+   * @return a future that becomes ready once the I/O is done
+   */
+  auto SchedulePageIO(bool is_write, page_id_t page_id, char *data) -> std::future<bool>;
+
+  /**
+   * @brief Write back a selection of frames of every shard, with all the writes scheduled at once.
+   *
+   * select is called with each shard's latch held and returns the frames to write, which have to be resident and not
+   * I/O pending. Each selected page is pinned and marked clean while its write is in flight.
+   *
+   * @return the number of pages written
+   */
+  auto WriteBackFrames(const std::function<std::vector<frame_id_t>(Shard &)> &select) -> size_t;
+
+  /**
+   * @brief Take the frames [frame_offset_ + num_frames, frame_offset_ + the shard's current number of frames) out of
+   * use, waiting until deadline for the pinned ones to be unpinned. See Resize().
+   * @return false if frames were still pinned at the deadline, the shard then keeps the frames up to the last of them
+   */
+  auto ShrinkShard(Shard &shard, size_t num_frames, std::chrono::steady_clock::time_point deadline) -> bool;
+
+  /** @return the number of frames out of total that the shard at index gets, if there are num_shards shards */
+  static auto ShardShare(size_t total, size_t num_shards, size_t index) -> size_t {
+    return total / num_shards + (index < total % num_shards ? 1 : 0);
+  }
+
+  /** Body of the background writer thread, see StartBackgroundWriter(). */
+  void BackgroundWriterLoop(double target_clean_ratio, std::chrono::milliseconds interval);
+
+  /**
+   * @brief Pin page_id if it is resident and its frame is not being taken for another page, without the shard latch.
+   * @return the pinned page, which may still be I/O pending, or nullptr if the caller has to take the shard latch
+   */
+  auto TryPinResident(Shard &shard, page_id_t page_id) -> Page *;
+
+  /**
+   * @brief Decrement the pin count of a page, and mark it dirty if is_dirty is set.
+   * @return false if the page was not pinned
+   */
+  auto UnpinFrame(Page *page, bool is_dirty) -> bool;
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Record a hit that did not take the shard latch.
+   *
+   * Hits are buffered in the shard's access_buffer_. The hit that fills the buffer hands its content to the replacer if
+   * the latch is free right away, otherwise the buffer wraps around and older hits are lost: the replacer only sees a
+   * sample of the hits under contention.
+   */
+  void RecordHit(Shard &shard, page_id_t page_id, AccessType access_type);
+
+  /** @brief Hand the buffered hits of the shard to its replacer. Caller should hold the shard latch. */
+  void DrainAccesses(Shard &shard);
+
+  /** Body of the read-ahead thread, see PrefetchPages(). */
+  void ReadAheadLoop();
+
+  /**
+   * @brief Read the given pages into the pool, if they exist and are not resident yet.
+   *
+   * The frames stay pinned until fetched, older read-ahead pages are released to make room for at most max_pinned.
+   */
+  void ReadAheadPages(const std::vector<page_id_t> &page_ids, size_t max_pinned);
+
+  /**
+   * @brief Read the given pages into the pool as AccessType::Scan pages, skipping those that are not allocated or
+   * already resident.
+   *
+   * A frame is reserved for every page first, pinned and I/O pending, then all the reads are scheduled at once.
+   *
+   * @param read_ahead keep the pages pinned until fetched and allow evicting clean frames, otherwise only free frames
+   * are used and the pages are unpinned once read
+   * @return the number of pages read
+   */
+  auto LoadPages(const std::vector<page_id_t> &page_ids, bool read_ahead) -> size_t;
+
+  /**
+   * @brief Fill the frame of page from the compressed cache, if enabled and holding the page. The frame takes over
+   * the dirty flag of the cached page.
+   * @return false if the page has to be read from disk
+   */
+  auto ReadFromCompressedCache(Page *page) -> bool;
+
+  /**
+   * @brief Give up the frame of a page whose read failed, in place of clearing its I/O pending flag. The frame goes
+   * back to the free list, and fetchers waiting for the page find it gone. Caller should hold the shard latch.
+   * @param unpin release the pin of the thread that read the page
+   */
+  void DropUnreadFrame(Shard &shard, Page *page, bool unpin);
+
+  /**
+   * @brief Take a frame from the shard's free list or evict one, and install page_id in it.
+   *
+   * The frame is pinned and marked I/O pending before the shard latch is released for writing back a dirty victim
+   * and, if read_page is set, reading page_id from disk. The latch is held again when this function returns.
+   *
+   * @param lock the caller's lock on the shard latch
+   * @param defer_read leave the frame I/O pending, for a read of page_id that the caller schedules itself
+   * @return the pinned page, or nullptr if every frame of the shard is pinned or the I/O failed. If the write-back of
+   * the victim failed, the victim stays in the frame.
+   */
+  auto GetAvailablePage(Shard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id, AccessType access_type,
+                        bool read_page, bool defer_read = false) -> Page *;
+
+  /**
+   * @brief Write page_id back to disk if it is resident in the shard. The page is pinned for the duration of the
+   * write, which happens without holding the shard latch.
+   * @param lock the caller's lock on the shard latch
+   * @return false if the page could not be found in the page table or the write failed, in which case the page stays
+   * dirty; true otherwise
+   */
+  auto FlushPageCommon(Shard &shard, std::unique_lock<std::mutex> &lock, page_id_t page_id) -> bool;
+
+  /**
+   * @brief Allocate a page on disk, reusing a deallocated page of the shard if there is one. Caller should acquire
+   * the shard latch before calling this function.
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(Shard &shard) -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, so that NewPage() can reuse its id. Caller should acquire the latch before
+   * calling this function, and make sure no write-back of the page is in flight.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+  /**
+   * @brief Take an unpinned frame out of the page table and put it on the free list, dropping its page without
+   * writing it. Caller should hold the shard latch.
+   * @return false if the frame is pinned
+   */
+  auto FreeFrame(Shard &shard, frame_id_t frame_id) -> bool;
 };
 }  // namespace bustub
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.h
+//
+// Identification: src/include/buffer/clock_pro_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/frame_replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ClockProReplacer implements the CLOCK-Pro policy (Jiang, Chen and Zhang, USENIX ATC '05).
+ *
+ * Pages are hot (a short reuse distance) or cold, and all of them sit on one clock together with the recently evicted
+ * cold pages that are still in their test period. A cold page starts a test period when it is loaded; if it is
+ * accessed again before the period ends, even after its eviction, it becomes hot. Three hands move around the clock:
+ *
+ * - HAND_cold evicts unreferenced cold pages, promotes referenced ones in their test period and gives the other
+ *   referenced ones a new test period.
+ * - HAND_hot demotes unreferenced hot pages to cold once there are too many hot pages, and ends the test periods it
+ *   passes.
+ * - HAND_test ends test periods and drops evicted pages, so that at most num_frames of them are remembered.
+ *
+ * The share of cold frames adapts: a page that is reused in its test period grows it, a test period that ends
+ * without reuse shrinks it. Pages loaded by scans are cold without a test period, so a scan never turns a page hot.
+ */
+class ClockProReplacer : public FrameReplacer {
+ public:
+  /** @param num_frames the maximum number of frames the replacer will be required to store */
+  explicit ClockProReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ClockProReplacer);
+
+  ~ClockProReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+  void RecordLoad(frame_id_t frame_id, page_id_t page_id) override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+  void Remove(frame_id_t frame_id) override;
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+  auto Size() -> size_t override;
+
+ private:
+  /** A page on the clock. */
+  struct Entry {
+    page_id_t page_id_;
+    /** Frame holding the page, INVALID_FRAME_ID for an evicted cold page in its test period. */
+    frame_id_t frame_id_;
+    bool is_hot_;
+    bool is_referenced_;
+    bool in_test_;
+  };
+
+  using Clock = std::list<Entry>;
+
+  static constexpr frame_id_t INVALID_FRAME_ID = -1;
+
+  /** Insert at the head of the clock, i.e. right behind HAND_hot, the last entry every hand reaches. */
+  auto Insert(const Entry &entry) -> Clock::iterator;
+  /** Remove an entry from the clock, moving the hands that point to it. */
+  void Erase(Clock::iterator it);
+  void Advance(Clock::iterator *hand);
+
+  /**
+   * Move HAND_cold by one entry.
+   * @param[out] frame_id the evicted frame, if any
+   * @return true if the entry was evicted
+   */
+  auto RunHandCold(frame_id_t *frame_id) -> bool;
+  /** Move HAND_hot by one entry. */
+  void RunHandHot();
+  /** Move HAND_test by one entry. */
+  void RunHandTest();
+  /** Drop an evicted page from the clock. */
+  void EraseNonResident(Clock::iterator it);
+  /** Make a resident page hot or cold, keeping the counters in sync. */
+  void SetHot(Entry *entry, bool is_hot);
+  /** End the test period of a page that was not reused in it, shrinking the cold target. */
+  void EndTestPeriod(Entry *entry);
+
+  auto HotTarget() const -> size_t { return num_frames_ - cold_target_; }
+
+  const size_t num_frames_;
+  Clock clock_;
+  Clock::iterator hand_hot_;
+  Clock::iterator hand_cold_;
+  Clock::iterator hand_test_;
+  /** Evicted cold pages in their test period. */
+  std::unordered_map<page_id_t, Clock::iterator> non_resident_;
+  /** Target number of resident cold pages, adapted between 1 and num_frames. */
+  size_t cold_target_;
+  size_t num_hot_{0};
+  size_t num_evictable_{0};
+  size_t num_evictable_cold_{0};
+
+  /** Per-frame state, indexed by frame id. */
+  std::vector<bool> is_tracked_;
+  std::vector<bool> is_evictable_;
+  std::vector<Clock::iterator> entry_of_;
+  /** The page announced by RecordLoad(), taken by the frame's first access. */
+  std::vector<page_id_t> loaded_page_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
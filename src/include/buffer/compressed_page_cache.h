@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/metrics.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageCache is an in-memory tier between a buffer pool and its disk, holding pages evicted from the pool
+ * compressed with PageCompressor.
+ *
+ * The cache is exclusive: a page is either resident in the pool or cached here, Get() hands the page back and drops
+ * it. Dirty pages are kept dirty, and only written to disk when the cache evicts them to stay within its capacity, or
+ * on Flush(). Pages are evicted in least recently cached order.
+ *
+ * The caller makes sure that a page is not cached twice, i.e. that Put() is only called for pages that are not cached,
+ * and that nobody reads a page from disk while it is being handed to Put().
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * @param capacity the number of bytes of compressed pages the cache holds at most
+   * @param disk_scheduler the scheduler that evicted dirty pages are written with
+   */
+  CompressedPageCache(size_t capacity, DiskScheduler *disk_scheduler);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * @brief Cache a page evicted from the pool, evicting other pages as needed.
+   *
+   * Pages that do not compress to at most MAX_COMPRESSED_SIZE bytes are not cached.
+   *
+   * @param data the BUSTUB_PAGE_SIZE bytes of the page
+   * @param is_dirty whether the page differs from its copy on disk
+   * @return true if the page was cached; if not, a dirty page has to be written to disk by the caller
+   */
+  auto Put(page_id_t page_id, const char *data, bool is_dirty) -> bool;
+
+  /**
+   * @brief Take a page out of the cache.
+   * @param[out] data the BUSTUB_PAGE_SIZE bytes of the page
+   * @param[out] is_dirty whether the page was put dirty, the caller is now responsible for writing it
+   * @return false if the page is not cached
+   */
+  auto Get(page_id_t page_id, char *data, bool *is_dirty) -> bool;
+
+  /** @brief Drop a page from the cache without writing it, e.g. when it is deleted. */
+  void Erase(page_id_t page_id);
+
+  /**
+   * @brief Write all the dirty pages of the cache to disk, they stay cached as clean pages.
+   * @return the number of pages written
+   */
+  auto Flush() -> size_t;
+
+  /** @brief Append the statistics of the cache to metrics, as tier.hits, tier.misses, ... */
+  void AppendMetrics(MetricList *metrics);
+
+  /** Largest compressed size of a page worth caching, a page that barely compresses is not worth the CPU time. */
+  static constexpr size_t MAX_COMPRESSED_SIZE = BUSTUB_PAGE_SIZE * 3 / 4;
+
+ private:
+  struct Entry {
+    std::string data_;
+    bool is_dirty_;
+    std::list<page_id_t>::iterator lru_pos_;
+  };
+
+  /**
+   * @brief Write dirty pages to disk and wait for the writes, then take them out of writeback_pages_. Caller should
+   * not hold the latch. Throws an Exception if a page could not be written, after all the others were.
+   * @param pages the ids and compressed data of the pages, which the caller added to writeback_pages_
+   */
+  void WriteBack(const std::vector<std::pair<page_id_t, std::string>> &pages);
+
+  const size_t capacity_;
+  DiskScheduler *disk_scheduler_;
+
+  /** Protects everything below. */
+  std::mutex latch_;
+  std::unordered_map<page_id_t, Entry> entries_;
+  /** Pages being written to disk by WriteBack(), which is done without the latch. Get() waits for them, so that a
+   * reader that misses the cache afterwards finds the page on disk. */
+  std::unordered_set<page_id_t> writeback_pages_;
+  /** Notifies Get() of the pages written back. */
+  std::condition_variable writeback_cv_;
+  /** Cached pages, the next page to evict first. */
+  std::list<page_id_t> lru_;
+  /** Bytes of compressed data held. */
+  size_t size_{0};
+
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+  std::atomic<size_t> rejected_{0};
+  std::atomic<size_t> evictions_{0};
+  std::atomic<size_t> dirty_writes_{0};
+  /** Bytes of all the pages cached so far, before and after compression. */
+  std::atomic<size_t> uncompressed_bytes_{0};
+  std::atomic<size_t> compressed_bytes_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the data of all the frames of a buffer pool in one contiguous, BUSTUB_PAGE_SIZE aligned region.
+ *
+ * Frames that are adjacent in the pool are adjacent in memory, so a pool needs far fewer TLB entries than with
+ * individually allocated frames, and every frame can be handed to O_DIRECT I/O as is. If huge pages are requested,
+ * the region is first mapped with explicit huge pages, then with transparent huge pages; without them, or if the
+ * platform has neither, it is made of regular pages.
+ */
+class FrameArena {
+ public:
+  /** How the memory of the arena is backed. */
+  enum class Backing { HugeTLB, TransparentHugePages, Pages };
+
+  /**
+   * @param num_frames number of frames in the arena
+   * @param use_huge_pages whether to try to back the arena with huge pages
+   */
+  explicit FrameArena(size_t num_frames, bool use_huge_pages = true);
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  ~FrameArena();
+
+  /** @return the data of the frame at the given index */
+  auto FrameData(size_t index) -> char * { return data_ + index * BUSTUB_PAGE_SIZE; }
+
+  /**
+   * @brief Give the memory of a range of frames back to the operating system, e.g. when the pool shrinks. The frames
+   * read as zeros the next time they are touched.
+   * @return false if the memory could not be released, the frames then keep their content
+   */
+  auto Release(size_t index, size_t num_frames) -> bool;
+
+  /** @return how the memory of the arena is backed */
+  auto GetBacking() const -> Backing { return backing_; }
+
+  /** @return a short name of the backing, for logs and benchmarks */
+  static auto BackingToString(Backing backing) -> std::string;
+
+ private:
+  char *data_;
+  /** Size of the mapping, the frames rounded up to the page size of the backing. */
+  size_t mapped_size_;
+  Backing backing_;
+};
+
+}  // namespace bustub
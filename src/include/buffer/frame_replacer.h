@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_replacer.h
+//
+// Identification: src/include/buffer/frame_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+enum class AccessType { Unknown = 0, Get, Scan };
+
+/** Number of values of AccessType, for tables indexed by access type. */
+static constexpr size_t NUM_ACCESS_TYPES = 3;
+
+/** The replacement policies the buffer pool can run with. */
+enum class ReplacerPolicy { LRUK = 0, ARC, TwoQ, ClockPro };
+
+/**
+ * FrameReplacer is the interface between the buffer pool manager and its replacement policy.
+ *
+ * The buffer pool tells the replacer which frames are accessed and which of them are evictable (unpinned), and asks
+ * it for a victim when it runs out of free frames. A frame is tracked from its first recorded access until it is
+ * evicted or removed; operations on a frame that is not tracked are ignored.
+ */
+class FrameReplacer {
+ public:
+  FrameReplacer() = default;
+  virtual ~FrameReplacer() = default;
+
+  /**
+   * @brief Evict an evictable frame chosen by the policy, and stop tracking it.
+   * @param[out] frame_id id of frame that is evicted
+   * @return true if a frame is evicted successfully, false if no frames can be evicted
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * @brief Tell the replacer that page_id is being loaded into the frame. Called before the first RecordAccess() of
+   * the frame, so that policies keeping a history of evicted pages can recognize a page that comes back.
+   */
+  virtual void RecordLoad(frame_id_t frame_id, page_id_t page_id) {}
+
+  /**
+   * @brief Record an access to the frame, starting to track it if it is not tracked yet. A newly tracked frame is
+   * not evictable.
+   */
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type) = 0;
+
+  /** @brief Mark a tracked frame as evictable or not. */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /**
+   * @brief Stop tracking an evictable frame, e.g. because its page was deleted. The page is forgotten rather than
+   * remembered as evicted. Throws if the frame is tracked and not evictable.
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /**
+   * @brief List the evictable frames in the order they would be evicted, without evicting them. Policies whose
+   * eviction order depends on the evictions themselves return their best estimate.
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames frame ids, the next victim first
+   */
+  virtual auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> = 0;
+
+  /** @return the number of evictable frames */
+  virtual auto Size() -> size_t = 0;
+};
+
+/**
+ * @brief Create a replacer for num_frames frames.
+ * @param replacer_k the lookback constant k, only used by ReplacerPolicy::LRUK
+ */
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t replacer_k) -> std::unique_ptr<FrameReplacer>;
+
+/** @return the policy named lru_k, arc, 2q or clock_pro (case insensitive), throws an Exception for other names */
+auto ReplacerPolicyFromString(const std::string &name) -> ReplacerPolicy;
+
+/** @return the name of the policy, as accepted by ReplacerPolicyFromString() */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string;
+
+}  // namespace bustub
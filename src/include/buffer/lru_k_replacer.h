@@ -12,56 +12,17 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
-#include <set>
-#include <memory>
 
+#include "buffer/frame_replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
-class LRUKNode {
- public:
-  LRUKNode() = default;
-
-  LRUKNode(frame_id_t fid, size_t k) : k_(k), fid_(fid) {}
-
-  auto GetFid() const -> frame_id_t { return fid_; }
-
-  void SetIsEvictable(bool isEvictable) { is_evictable_ = isEvictable; }
-
-  auto IsEvictable() const -> bool { return is_evictable_; }
-
-  auto GetHistorySize() const -> size_t { return history_.size();}
-
-  void ClearHistory() { history_.clear(); }
-
-  auto GetK() const -> size_t { return k_; }
-
-  auto GetFrontHistory() const -> size_t { return history_.front(); }
-
-  void AddHistoryEntry(size_t timestamp) {
-    history_.push_back(timestamp);
-    if (GetHistorySize() > k_) {
-      history_.pop_front();
-    }
-  }
-
- private:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  std::list<size_t> history_;
-  size_t k_{};
-  frame_id_t fid_{};
-  bool is_evictable_{false};
-};
-
 /**
  * LRUKReplacer implements the LRU-k replacement policy.
  *
@@ -72,8 +33,18 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Scan accesses do not count toward the k-distance. A frame that has only been accessed by scans sits in a
+ * probationary group that is evicted, in LRU order, before any other frame, so a large sequential scan recycles its
+ * own frames instead of flushing the working set. A scan of a frame with other accesses leaves its history untouched,
+ * and the first non-scan access of a scan-only frame starts its history afresh.
+ *
+ * All state is allocated up front: the nodes live in an array indexed by frame id, the last k timestamps of every
+ * frame in a ring buffer of a shared array, and the evictable frames in an intrusive binary heap keyed by their
+ * eviction order. Recording an access or toggling evictability never allocates, and the next victim is the top of
+ * the heap.
  */
-class LRUKReplacer {
+class LRUKReplacer : public FrameReplacer {
  public:
   /**
    * @brief a new LRUKReplacer.
@@ -86,7 +57,7 @@ class LRUKReplacer {
   /**
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * @brief Find the frame with largest backward k-distance and evict that frame. Only frames
@@ -102,7 +73,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * @brief Record the event that the given frame id is accessed at current timestamp.
@@ -115,7 +86,8 @@ class LRUKReplacer {
    * @param access_type type of access that was received. This parameter is only needed for
    * leaderboard tests.
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id,
+                    AccessType access_type = AccessType::Unknown) override;  // NOLINT(google-default-arguments)
 
   /**
    * @brief Toggle whether a frame is evictable or non-evictable. This function also
@@ -132,7 +104,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * @brief Remove an evictable frame from replacer, along with its access history.
@@ -149,40 +121,66 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
+
+  /**
+   * @brief List the evictable frames in the order they would be evicted, without evicting them.
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames frame ids, the next victim first
+   */
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
 
   /**
    * @brief Return replacer's size, which tracks the number of evictable frames.
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
  private:
-  struct LRUKHeapLess {
-    auto operator()(const std::shared_ptr<LRUKNode> &left, const std::shared_ptr<LRUKNode> &right) const -> bool {
-      if (left->GetFid() == right->GetFid()) {
-        return false;
-      }
-
-      size_t k = left->GetK();
-      if (left->GetHistorySize() < k && right->GetHistorySize() < k) {
-        return left->GetFrontHistory() < right->GetFrontHistory();
-      }
-      if (left->GetHistorySize() < k) {
-        return true;
-      }
-      if (right->GetHistorySize() < k) {
-        return false;
-      }
-
-      return left->GetFrontHistory() < right->GetFrontHistory();
-    }
+  /** Per-frame state, stored in nodes_ at the frame's index. */
+  struct FrameNode {
+    /** Position in the frame's history ring buffer where the next timestamp goes. */
+    size_t history_head_{0};
+    /** Number of timestamps in the ring buffer, at most k. A frame without history is not tracked. */
+    size_t history_size_{0};
+    /** Position of the frame in heap_, INVALID_HEAP_INDEX if the frame is not evictable. */
+    size_t heap_index_{INVALID_HEAP_INDEX};
+    /** True if the frame has only been accessed by scans since it was loaded. */
+    bool is_scan_only_{false};
+  };
+
+  /** An evictable frame in heap_, with its eviction key cached next to it. */
+  struct HeapEntry {
+    uint64_t key_;
+    frame_id_t frame_id_;
   };
 
-  using LRUKHeap = std::set<std::shared_ptr<LRUKNode>, LRUKHeapLess>;
+  static constexpr size_t INVALID_HEAP_INDEX = std::numeric_limits<size_t>::max();
 
-  LRUKHeap evictable_frames_;
-  std::unordered_map<frame_id_t, std::shared_ptr<LRUKNode>> node_store_;
+  /**
+   * The eviction order of a frame as one integer, smaller is evicted first: scan-only frames, then frames with less
+   * than k accesses, then the rest, each group ordered by the oldest timestamp in the frame's history.
+   */
+  auto EvictionKey(frame_id_t frame_id) const -> uint64_t;
+  /** Append a timestamp to the frame's history, overwriting the oldest one once there are k. */
+  void AddHistoryEntry(frame_id_t frame_id, size_t timestamp);
+  /** Forget the frame's history, it is no longer tracked afterwards. */
+  void ClearHistory(frame_id_t frame_id);
+
+  void HeapPush(frame_id_t frame_id);
+  void HeapErase(frame_id_t frame_id);
+  /** Restore the heap order after the key of the entry at index has changed. */
+  void HeapFix(size_t index);
+  void HeapSiftUp(size_t index);
+  void HeapSiftDown(size_t index);
+  void HeapSwap(size_t a, size_t b);
+
+  std::vector<FrameNode> nodes_;
+  /** The history ring buffers, k timestamps per frame, the frame's buffer starting at frame_id * k. */
+  std::vector<size_t> history_;
+  /** Binary min-heap of the evictable frames by eviction key, never holds more than num_frames entries. */
+  std::vector<HeapEntry> heap_;
   size_t current_timestamp_{0};
   size_t replacer_size_;
   size_t k_;
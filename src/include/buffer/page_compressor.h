@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.h
+//
+// Identification: src/include/buffer/page_compressor.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * PageCompressor compresses BUSTUB_PAGE_SIZE pages with a byte-oriented LZ77 scheme laid out like an LZ4 block.
+ *
+ * The output is a list of sequences, each a token byte (literal length in the high nibble, match length minus 4 in
+ * the low nibble, 15 meaning more length bytes follow), the literals, then a 2-byte little endian offset back into the
+ * page. The last sequence only has literals. Matches are found with a single-probe hash table of 4-byte prefixes,
+ * which is fast rather than thorough: zero-filled and integer-heavy pages compress well, random data does not.
+ */
+class PageCompressor {
+ public:
+  /**
+   * @brief Compress a page.
+   * @param page the BUSTUB_PAGE_SIZE bytes to compress
+   * @param[out] out the compressed page
+   * @param capacity the size of out
+   * @return the size of the compressed page, 0 if it does not fit in capacity
+   */
+  static auto Compress(const char *page, char *out, size_t capacity) -> size_t;
+
+  /**
+   * @brief Decompress a page compressed by Compress().
+   * @param in the compressed page
+   * @param size the size of the compressed page
+   * @param[out] page the BUSTUB_PAGE_SIZE bytes of the page
+   * @return false if in is not a valid compressed page
+   */
+  static auto Decompress(const char *in, size_t size, char *page) -> bool;
+};
+
+}  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the page ids of a buffer pool shard to the frames holding them.
+ *
+ * It is an open-addressing hash table with linear probing and a fixed capacity, every slot is a single atomic word
+ * holding a page id and its frame id. Insert() and Erase() have to be serialized by the caller, Find() may run
+ * concurrently with them without any lock. A concurrent Find() never returns a mapping that was not in the table at some
+ * point, but it can miss a mapping that an Erase() is moving to close the gap it leaves behind; lock-free readers have
+ * to validate what they find and retry under the writers' lock when they find nothing.
+ */
+class PageTable {
+ public:
+  /** @param max_entries the largest number of mappings the table will hold */
+  explicit PageTable(size_t max_entries);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * @brief Look up the frame of a page.
+   * @param[out] frame_id the frame holding page_id, if found
+   * @return true if page_id was found
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /** @brief Add a mapping for page_id, which must not be in the table yet. */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of page_id.
+   * @return true if page_id was found
+   */
+  auto Erase(page_id_t page_id) -> bool;
+
+  /** @brief Call fn with every mapping of the table. Must not run concurrently with Insert() or Erase(). */
+  void ForEach(const std::function<void(page_id_t, frame_id_t)> &fn) const;
+
+  /** @return the number of mappings in the table */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  /** The page id in the high half of a slot, the frame id in the low half. */
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static auto MakeSlot(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32 | static_cast<uint32_t>(frame_id);
+  }
+  static auto SlotPageId(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto SlotFrameId(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the slot that the probe for page_id starts at */
+  auto HomeSlot(page_id_t page_id) const -> size_t;
+
+  /** Number of slots minus one, the number of slots is a power of two. */
+  size_t mask_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t size_{0};
+};
+
+}  // namespace bustub
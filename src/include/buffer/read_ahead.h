@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * ReadAhead decides which pages a scan that follows next-page links should hint to the buffer pool.
+ *
+ * The scan reports every page it moves to together with the page's successor. The successor is always hinted. Once the
+ * scan has moved to the next page id twice in a row, pages are laid out sequentially and the following page ids are
+ * hinted as well, in a window that starts at INITIAL_WINDOW pages and doubles, up to max_window, every time the scan
+ * has consumed half of what was hinted. A link that breaks the sequence shrinks the window back to a single page.
+ */
+class ReadAhead {
+ public:
+  /** Window of the first sequential hint. */
+  static constexpr size_t INITIAL_WINDOW = 4;
+  /** Upper bound of the window, further capped to a quarter of the buffer pool. */
+  static constexpr size_t MAX_WINDOW = 64;
+
+  /**
+   * @param bpm the buffer pool to hint, nullptr disables read-ahead
+   * @param max_window the largest number of pages hinted ahead of the scan
+   */
+  explicit ReadAhead(BufferPoolManager *bpm, size_t max_window = MAX_WINDOW);
+
+  /**
+   * @brief Report that the scan moved to page_id.
+   * @param page_id the page the scan is on, reporting the same page again does nothing
+   * @param next_page_id the page linked after it, INVALID_PAGE_ID if it is the last one
+   */
+  void OnPage(page_id_t page_id, page_id_t next_page_id);
+
+  /** @return the number of pages currently hinted ahead of the scan once it is sequential */
+  auto GetWindow() const -> size_t { return window_; }
+
+ private:
+  BufferPoolManager *bpm_;
+  size_t max_window_;
+  /** Current window, 0 until the scan is found to be sequential. */
+  size_t window_{0};
+  /** The page reported last. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** The page right after the last one hinted. */
+  page_id_t hinted_end_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
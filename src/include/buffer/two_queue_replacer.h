@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/frame_replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q policy (Johnson and Shasha, VLDB '94).
+ *
+ * A newly loaded page enters A1in, a FIFO that absorbs the correlated accesses right after a page is loaded: further
+ * accesses while the page is in A1in are ignored. When A1in is above its share of the frames, its oldest frame is
+ * evicted and the page is remembered in the ghost FIFO A1out. A page loaded again while in A1out has proven to be
+ * reused and goes to Am, an LRU list that holds the working set. Pages evicted from Am are forgotten.
+ *
+ * Scan accesses never refresh a frame in Am.
+ */
+class TwoQueueReplacer : public FrameReplacer {
+ public:
+  /** @param num_frames the maximum number of frames the replacer will be required to store */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+  void RecordLoad(frame_id_t frame_id, page_id_t page_id) override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+  void Remove(frame_id_t frame_id) override;
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+  auto Size() -> size_t override;
+
+  /** Share of the frames that A1in may hold before its frames are evicted first, as in the paper. */
+  static constexpr double A1IN_RATIO = 0.25;
+  /** Number of pages A1out remembers, relative to the number of frames, as in the paper. */
+  static constexpr double A1OUT_RATIO = 0.5;
+
+ private:
+  enum class ListId { None = 0, A1In, Am };
+
+  /** Stop tracking the frame, remembering its page in A1out if remember is set and it was in A1in. */
+  void Untrack(frame_id_t frame_id, bool remember);
+  /** @return true if the next victim should come from A1in */
+  auto ShouldEvictFromA1In() const -> bool;
+  auto ResidentList(ListId list) -> std::list<frame_id_t> & { return list == ListId::A1In ? a1in_ : am_; }
+
+  const size_t num_frames_;
+  const size_t max_a1in_;
+  const size_t max_a1out_;
+  /** Resident frames, oldest (A1in) or least recently used (Am) first. */
+  std::list<frame_id_t> a1in_;
+  std::list<frame_id_t> am_;
+  /** Pages of frames evicted from A1in, oldest first. */
+  std::list<page_id_t> a1out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_index_;
+
+  /** Per-frame state, indexed by frame id. */
+  std::vector<ListId> list_of_;
+  std::vector<std::list<frame_id_t>::iterator> position_;
+  std::vector<bool> is_evictable_;
+  std::vector<page_id_t> page_of_;
+  /** Set by RecordLoad() for a page found in A1out, the frame starts in Am. */
+  std::vector<bool> is_ghost_hit_;
+  /** Number of evictable frames in A1in and Am, indexed by ListId. */
+  size_t num_evictable_[3]{};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
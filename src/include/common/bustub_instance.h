@@ -39,6 +39,7 @@ class LockManager;
 class TransactionManager;
 class LogManager;
 class CheckpointManager;
+class VacuumWorker;
 class Catalog;
 class ExecutionEngine;
 
@@ -261,6 +262,8 @@ class BustubInstance {
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
   ExecutionEngine *execution_engine_;
+  /** Reclaims the space of deleted tuples, in the background unless in memory. Null without a buffer pool. */
+  VacuumWorker *vacuum_worker_{nullptr};
   std::shared_mutex catalog_lock_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
@@ -279,6 +282,8 @@ class BustubInstance {
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdDisplayStats(ResultWriter &writer);
+  void CmdVacuum(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
 
   void HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer);
@@ -288,6 +293,8 @@ class BustubInstance {
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
 
   std::unordered_map<std::string, std::string> session_variables_;
+  /** File the resident pages of the buffer pool are saved to on shutdown and warmed up from, empty if in memory. */
+  std::string warm_up_file_name_;
 };
 
 }  // namespace bustub
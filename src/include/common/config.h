@@ -33,9 +33,16 @@ static constexpr int INVALID_LSN = -1;
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
 static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
+static constexpr int BUSTUB_CACHELINE_SIZE = 64;                                     // size of a cpu cache line
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int DISK_SCHEDULER_WORKERS = 4;  // number of background I/O threads of a disk scheduler
+static constexpr int OPTIMISTIC_READ_ATTEMPTS = 3;  // tries of a latch-free read before it latches the page
+static constexpr size_t INDEX_SCAN_BATCH_SIZE = 64;  // rids whose tuples an index scan reads with one batch fetch
+static constexpr size_t PARALLEL_SCAN_MAX_WORKERS = 32;  // worker threads of a parallel sequential scan
+static constexpr size_t PARALLEL_SCAN_MIN_PAGES = 64;     // tables with fewer pages are scanned on one thread
+static constexpr std::chrono::milliseconds BUFFER_POOL_RESIZE_TIMEOUT{5000};  // how long shrinking waits for pins
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.h
+//
+// Identification: src/include/common/metrics.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** A list of named metric values, as reported by the components that keep metrics. */
+using MetricList = std::vector<std::pair<std::string, uint64_t>>;
+
+/** Number of stripes of a StripedCounter or LatencyHistogram; threads are spread over them. */
+static constexpr size_t METRIC_STRIPES = 16;
+
+/** @return the stripe the calling thread updates */
+auto MetricStripe() -> size_t;
+
+/**
+ * StripedCounter is a counter that many threads can increment without contending on one cache line.
+ *
+ * Every thread adds to its own stripe, each on its own cache line; reading the counter sums the stripes, and may miss
+ * increments that happen while it does so.
+ */
+class StripedCounter {
+ public:
+  StripedCounter() = default;
+  DISALLOW_COPY_AND_MOVE(StripedCounter);
+
+  void Add(uint64_t value = 1) { stripes_[MetricStripe()].value_.fetch_add(value, std::memory_order_relaxed); }
+
+  auto Get() const -> uint64_t;
+
+ private:
+  struct alignas(BUSTUB_CACHELINE_SIZE) Stripe {
+    std::atomic<uint64_t> value_{0};
+  };
+  std::array<Stripe, METRIC_STRIPES> stripes_;
+};
+
+/**
+ * LatencyHistogram counts durations in buckets of powers of two nanoseconds, bucket i holding the durations in
+ * [2^(i-1), 2^i) ns. Like StripedCounter, every thread records into its own stripe.
+ */
+class LatencyHistogram {
+ public:
+  /** Number of buckets, the last one holds every duration of 2^(NUM_BUCKETS - 2) ns (about 9 minutes) or more. */
+  static constexpr size_t NUM_BUCKETS = 40;
+
+  LatencyHistogram() = default;
+  DISALLOW_COPY_AND_MOVE(LatencyHistogram);
+
+  void Record(std::chrono::nanoseconds duration);
+
+  /** @brief Record the time elapsed since start. */
+  void RecordSince(std::chrono::steady_clock::time_point start) { Record(std::chrono::steady_clock::now() - start); }
+
+  /** @return the number of durations recorded */
+  auto Count() const -> uint64_t;
+
+  /** @return the sum of the durations recorded, in nanoseconds */
+  auto Sum() const -> uint64_t;
+
+  /**
+   * @return an upper bound of the given percentile of the durations recorded, in nanoseconds: the upper end of the
+   * bucket holding it. 0 if nothing was recorded.
+   */
+  auto Percentile(double percentile) const -> uint64_t;
+
+  /** @brief Append the count, mean, p50, p99 and max of the histogram to metrics, as name.count, name.avg_us, ... */
+  void AppendTo(const std::string &name, MetricList *metrics) const;
+
+ private:
+  struct alignas(BUSTUB_CACHELINE_SIZE) Stripe {
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> sum_{0};
+  };
+  std::array<Stripe, METRIC_STRIPES> stripes_;
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <set>
 #include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -55,6 +56,7 @@ class TransactionManager {
 
     std::unique_lock<std::shared_mutex> l(txn_map_mutex_);
     txn_map_[txn->GetTransactionId()] = txn;
+    running_txns_.insert(txn->GetTransactionId());
     return txn;
   }
 
@@ -91,6 +93,15 @@ class TransactionManager {
     return res;
   }
 
+  /**
+   * @return the id of the oldest transaction that has not committed or aborted yet, or the id of the next transaction
+   * if none is running. Tuples deleted by older transactions are not visible to anyone anymore.
+   */
+  auto GetOldestActiveTxnId() -> txn_id_t {
+    std::shared_lock<std::shared_mutex> l(txn_map_mutex_);
+    return running_txns_.empty() ? next_txn_id_.load() : *running_txns_.begin();
+  }
+
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
 
@@ -148,7 +159,15 @@ class TransactionManager {
     }
   }
 
+  /** Forget a transaction that has committed or aborted. */
+  void Finish(Transaction *txn) {
+    std::unique_lock<std::shared_mutex> l(txn_map_mutex_);
+    running_txns_.erase(txn->GetTransactionId());
+  }
+
   std::atomic<txn_id_t> next_txn_id_{0};
+  /** Transactions that have not committed or aborted yet, protected by txn_map_mutex_. */
+  std::set<txn_id_t> running_txns_;
   LockManager *lock_manager_ __attribute__((__unused__));
   LogManager *log_manager_ __attribute__((__unused__));
   ReaderWriterLatch global_txn_latch_;
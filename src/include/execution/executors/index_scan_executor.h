@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
@@ -48,5 +49,9 @@ class IndexScanExecutor : public AbstractExecutor {
   IndexInfo *index_info_;
   BPlusTreeIndexForTwoIntegerColumn *tree_;
   std::optional<BPlusTreeIndexIteratorForTwoIntegerColumn> iter_;
+  /** Tuples read for the rids that the iterator returned last, fetched with one TableHeap::GetTuples(). */
+  std::vector<std::pair<TupleMeta, Tuple>> batch_;
+  /** Position of the next tuple of batch_ to return. */
+  size_t batch_pos_{0};
 };
 }  // namespace bustub
\ No newline at end of file
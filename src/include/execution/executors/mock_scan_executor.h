@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "common/metrics.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/mock_scan_plan.h"
@@ -79,6 +80,9 @@ class MockScanExecutor : public AbstractExecutor {
 
   /** The shuffled output */
   std::vector<size_t> shuffled_idx_;
+
+  /** The rows of __buffer_pool_stats */
+  MetricList metrics_;
 };
 
 }  // namespace bustub
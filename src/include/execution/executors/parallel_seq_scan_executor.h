@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_seq_scan_executor.h
+//
+// Identification: src/include/execution/executors/parallel_seq_scan_executor.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "execution/executors/seq_scan_executor.h"
+#include "storage/table/table_iterator.h"
+
+namespace bustub {
+
+/**
+ * ParallelSeqScanExecutor executes a sequential table scan on several threads.
+ *
+ * The executor walks the page chain of the table and hands the pages out, one morsel per page, to worker threads that
+ * read them, check visibility and the filter, and copy out the tuples that pass. Above them, Next() gathers the
+ * batches of the workers in page order, so the tuples come out in the same order as from a SeqScanExecutor.
+ *
+ * Rows are locked the same way as by a SeqScanExecutor, on the thread calling Next(): the rows of a page are locked
+ * before the page is handed out, and a morsel only covers the rows locked for it.
+ */
+class ParallelSeqScanExecutor : public SeqScanExecutor {
+ public:
+  /** At most this many pages per worker are handed out ahead of the page being gathered. */
+  static constexpr size_t MORSELS_PER_WORKER = 2;
+
+  /**
+   * Construct a new ParallelSeqScanExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @param num_workers The number of worker threads
+   */
+  ParallelSeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, size_t num_workers);
+
+  ~ParallelSeqScanExecutor() override;
+
+  /** Initialize the sequential scan, and start the workers on the first call */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the sequential scan.
+   * @param[out] tuple The next tuple produced by the scan
+   * @param[out] rid The next tuple RID produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+ private:
+  /** The tuples of a page, read by a worker. */
+  struct Morsel {
+    size_t scan_;
+    size_t seq_;
+    TableIterator iter_;
+  };
+
+  /** Lock and hand out pages until enough are ahead of the page being gathered. */
+  void Dispatch();
+
+  /** Read the morsels handed out, until the workers are stopped. */
+  void Work();
+
+  /** Stop the workers, the morsels they have not read are dropped. */
+  void StopWorkers();
+
+  size_t num_workers_;
+  std::vector<std::thread> workers_;
+
+  /** Sequence number of the next morsel to hand out, and of the next one to gather. */
+  size_t next_dispatch_seq_{0};
+  size_t next_gather_seq_{0};
+
+  std::mutex latch_;
+  /** Notifies the workers of new morsels, and of being stopped. */
+  std::condition_variable morsel_cv_;
+  /** Notifies Next() of the batches read. */
+  std::condition_variable batch_cv_;
+  std::deque<Morsel> morsels_;                            /* protected by latch_ */
+  std::unordered_map<size_t, std::vector<Tuple>> batches_; /* protected by latch_ */
+  std::exception_ptr error_;                              /* protected by latch_ */
+  /** Counts the calls to Init(), the batches of the morsels of an earlier scan are dropped. */
+  size_t scan_{0};      /* protected by latch_ */
+  bool stopped_{false}; /* protected by latch_ */
+};
+
+}  // namespace bustub
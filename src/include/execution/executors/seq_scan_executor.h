@@ -47,14 +47,29 @@ class SeqScanExecutor : public AbstractExecutor {
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
- private:
+ protected:
+  /**
+   * Lock the rows the next read of the iterator returns, as the isolation level requires. Must not be called with a page
+   * latched, the holder of a lock may need to write the page.
+   * @return the number of tuples to read, see TableIterator::NextPage()
+   */
+  auto LockPage() -> size_t;
+
+  /** Release the locks a READ_COMMITTED scan no longer needs once it is done. */
+  void FinishScan();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
 
-  //  const TableInfo info;
-
   std::optional<TableIterator> it_;
 
+  /** Keeps the tuples that are not deleted and pass the filter pushed into the scan, see TableIterator::NextPage(). */
+  TableIterator::TupleFilter filter_;
+
+  /** The tuples of the page read last that passed the filter, returned from batch_pos_ on. */
+  std::vector<Tuple> batch_;
+  size_t batch_pos_{0};
+
   Transaction *txn_;
 };
 }  // namespace bustub
\ No newline at end of file
@@ -16,7 +16,9 @@
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
+#include <set>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -25,6 +27,10 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are allocated from the start of the file: deallocated pages are kept in a free list and handed out again,
+ * lowest page id first, before the file is extended. Free pages at the end of the file are cut off by ShrinkToFit().
+ * The allocation state is saved next to the database file on ShutDown() and restored when the file is opened again.
  */
 class DiskManager {
  public:
@@ -42,7 +48,7 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -51,6 +57,14 @@ class DiskManager {
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write consecutive pages to the database file, starting at first_page_id. Subclasses may do this with a single
+   * vectored write; by default every page is written with WritePage().
+   * @param first_page_id id of the first page
+   * @param pages_data raw data of the pages, pages_data[i] is written to page first_page_id + i
+   */
+  virtual void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -83,6 +97,37 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /**
+   * Allocate a page, reusing the lowest deallocated page if there is one. The page ids can be restricted to
+   * page_id % stride == offset, so that each shard of a buffer pool gets page ids that map to itself.
+   * @param stride the number of page id classes
+   * @param offset the class of the page id to allocate
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(size_t stride = 1, size_t offset = 0) -> page_id_t;
+
+  /**
+   * Deallocate a page, so that its id can be reused. Deallocating a page that is not allocated does nothing.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if page_id is allocated */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /** @return the number of pages the database spans, including the free pages in between */
+  auto GetNumPages() -> size_t;
+
+  /** @return the number of free pages below GetNumPages() */
+  auto GetNumFreePages() -> size_t;
+
+  /**
+   * Truncate the database file after its last allocated page. The file is left alone if it holds pages that were
+   * written without being allocated.
+   * @return the number of pages cut off the file
+   */
+  auto ShrinkToFit() -> size_t;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,7 +138,26 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
+  /**
+   * Derive the log file name from file_name_ and open (or create) the log file.
+   * @return false if file_name_ has no extension to replace, true otherwise
+   */
+  auto OpenLogFile() -> bool;
+
   auto GetFileSize(const std::string &file_name) -> int;
+
+  /**
+   * Restore the allocation state saved by SavePageMap(), if it was saved for the database file as it is now.
+   * Otherwise no page is allocated.
+   */
+  void LoadPageMap();
+
+  /** Save the allocation state next to the database file. */
+  void SavePageMap();
+
+  /** @return the free pages whose id % stride == offset, regrouping the free pages if the stride changed */
+  auto FreePagesOf(size_t stride, size_t offset) -> std::set<page_id_t> &;
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -101,11 +165,23 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+
+  // file the allocation state is saved to
+  std::string page_map_name_;
+  // protects the allocation state below
+  std::mutex alloc_latch_;
+  // pages below this id are allocated or free, the file may end before it
+  page_id_t num_pages_{0};
+  // the highest num_pages_ ever reached, the file never holds allocated pages past it
+  page_id_t max_num_pages_{0};
+  // free pages grouped by page_id % free_pages_.size(), the stride of the last allocation
+  std::vector<std::set<page_id_t>> free_pages_{1};
+  size_t num_free_pages_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerPosix reads and writes pages with positional pread / pwrite calls on a plain file descriptor. Since no
+ * shared file position is involved, page I/O does not go through db_io_latch_ and concurrent requests for different
+ * pages run in parallel.
+ *
+ * With direct_io the file is opened with O_DIRECT, so that the OS page cache does not keep a second copy of the pages
+ * that are already cached by the buffer pool. O_DIRECT requires BUSTUB_PAGE_SIZE aligned buffers; requests with an
+ * unaligned buffer are bounced through an aligned per-thread buffer. If the file system does not support O_DIRECT,
+ * the file is opened for buffered I/O instead.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io whether to bypass the OS page cache with O_DIRECT
+   */
+  explicit DiskManagerPosix(const std::string &db_file, bool direct_io = false);
+
+  ~DiskManagerPosix() override;
+
+  /**
+   * Shut down the disk manager and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Write consecutive pages to the database file with vectored pwritev calls.
+   * @param first_page_id id of the first page
+   * @param pages_data raw data of the pages
+   */
+  void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data) override;
+
+  /**
+   * Read a page from the database file.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /** @return true if the file is opened with O_DIRECT */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
+ protected:
+  /** File descriptor of the database file. */
+  int db_fd_{-1};
+  /** True if db_fd_ was opened with O_DIRECT. */
+  bool direct_io_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerUring performs page I/O through a Linux io_uring instance, so that many reads and writes can be in
+ * flight at the same time instead of one per process.
+ *
+ * Requests are queued on the submission queue by ReadPageAsync() / WritePageAsync() and handed to the kernel in one
+ * batch by Submit(). A background reaper thread drains the completion queue and fulfills the returned futures. The
+ * synchronous ReadPage() / WritePage() are built on top of the asynchronous calls.
+ *
+ * If io_uring is not available (old kernel, seccomp sandbox, non-Linux platform), every request is served
+ * synchronously by DiskManagerPosix in the calling thread, and the returned futures are already ready. If the ring
+ * fails, the requests it holds fail, i.e. their futures become false, and the following ones are served synchronously.
+ */
+class DiskManagerUring : public DiskManagerPosix {
+ public:
+  /**
+   * Creates a new io_uring disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param queue_depth the number of submission queue entries, i.e. the maximum number of requests in flight
+   */
+  explicit DiskManagerUring(const std::string &db_file, uint32_t queue_depth = 64);
+
+  ~DiskManagerUring() override;
+
+  /**
+   * Wait for all requests in flight, stop the reaper and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file and wait for the write to complete.
+   * Throws an Exception if the write fails.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file and wait for the read to complete.
+   * Throws an Exception if the read fails.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Queue a page read. The request is handed to the kernel by the next Submit().
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, must stay valid until the future is ready
+   * @return a future that becomes true once the page is read, or false on an I/O error
+   */
+  auto ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /**
+   * Queue a page write. The request is handed to the kernel by the next Submit().
+   * @param page_id id of the page
+   * @param page_data raw page data, must stay valid and unchanged until the future is ready
+   * @return a future that becomes true once the page is written, or false on an I/O error
+   */
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool>;
+
+  /**
+   * Submit all queued requests to the kernel with a single system call.
+   */
+  void Submit();
+
+  /** @return true if requests go through io_uring, false if the synchronous fallback is used */
+  auto IsAsync() const -> bool { return ring_fd_ >= 0; }
+
+ private:
+  /** A request that has been queued or submitted and not yet completed. */
+  struct InflightRequest {
+    std::promise<bool> promise_;
+    char *read_data_;
+  };
+
+  /** Set up the ring. Leaves ring_fd_ at -1 if io_uring cannot be used. */
+  void SetUpRing(uint32_t queue_depth);
+
+  /** Queue one read or write on the submission queue, blocking while the ring is full. */
+  auto Enqueue(bool is_write, page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /** Submit the queued entries. Caller should hold sq_latch_. */
+  void SubmitLocked();
+
+  /**
+   * Take the entries the kernel has not consumed back off the submission queue and fail their requests. Caller should
+   * hold sq_latch_.
+   */
+  void FailQueuedLocked();
+
+  /** Serve one read or write with DiskManagerPosix in the calling thread. */
+  auto RequestSync(bool is_write, page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /** Body of the reaper thread that drains the completion queue. */
+  void ReapCompletions();
+
+  /** File descriptor of the io_uring instance, -1 when falling back to synchronous I/O. */
+  int ring_fd_{-1};
+
+  /** Memory mapped rings, see io_uring_setup(2). */
+  void *sq_ring_ptr_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_ptr_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_ptr_{nullptr};
+  size_t sqes_size_{0};
+
+  /** Pointers into the submission queue ring, shared with the kernel. */
+  uint32_t *sq_head_{nullptr};
+  uint32_t *sq_tail_{nullptr};
+  uint32_t *sq_array_{nullptr};
+  uint32_t sq_mask_{0};
+  uint32_t sq_entries_{0};
+  /** Pointers into the completion queue ring, shared with the kernel. */
+  uint32_t *cq_head_{nullptr};
+  uint32_t *cq_tail_{nullptr};
+  void *cqes_{nullptr};
+  uint32_t cq_mask_{0};
+
+  /** Protects the submission queue, inflight_, next_request_id_, failed_ and stop_. */
+  std::mutex sq_latch_;
+  /** Signalled when a completion frees a slot in the ring. */
+  std::condition_variable sq_cv_;
+  /** Signalled when entries are handed to the kernel, and on shutdown. */
+  std::condition_variable reap_cv_;
+  /** Number of entries queued but not yet handed to the kernel. */
+  uint32_t to_submit_{0};
+  /** Requests in flight keyed by the user_data of their submission entry. */
+  std::unordered_map<uint64_t, InflightRequest> inflight_;
+  uint64_t next_request_id_{1};
+  /** Set once the reaper stopped on an error, from then on requests are served synchronously. */
+  bool failed_{false};
+
+  bool stop_{false};
+  std::thread reaper_;
+};
+
+}  // namespace bustub
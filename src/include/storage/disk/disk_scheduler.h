@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/metrics.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+};
+
+using DiskSchedulerPromise = std::promise<bool>;
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. Schedule() only
+ * queues the request and returns; a pool of background worker threads executes the queued requests and sets the
+ * request's promise once it is done, so the issuer decides whether and when to wait for it.
+ *
+ * Requests for the same page are executed in the order they were scheduled. A worker either executes one read, or
+ * takes up to MAX_WRITE_BATCH queued writes at once, sorts them by page id and hands runs of adjacent pages to
+ * DiskManager::WritePages() as a single vectored write.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @param disk_manager the disk manager that executes the requests, must be safe to call from several threads
+   * @param num_workers number of background worker threads
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_WORKERS);
+  ~DiskScheduler();
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Schedules several requests at once, e.g. all the writes of a flush, so that they can be merged.
+   * @param requests The requests to be scheduled, in order.
+   */
+  void Schedule(std::vector<DiskRequest> requests);
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this function
+   * so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  auto CreatePromise() -> DiskSchedulerPromise { return {}; };
+
+  /** @return the disk manager behind this scheduler */
+  auto GetDiskManager() -> DiskManager * { return disk_manager_; }
+
+  /** @return the time the disk manager took for each page read */
+  auto GetReadLatency() const -> const LatencyHistogram & { return read_latency_; }
+
+  /** @return the time the disk manager took for each write call, of one page or a run of adjacent pages */
+  auto GetWriteLatency() const -> const LatencyHistogram & { return write_latency_; }
+
+  /** Maximum number of writes a worker takes off the queue at once. */
+  static constexpr size_t MAX_WRITE_BATCH = 64;
+
+ private:
+  /** Body of a worker thread, runs until the scheduler is destroyed and the queue is drained. */
+  void StartWorkerThread();
+
+  /**
+   * Take the next batch off the queue: the first request whose page has no request in progress, plus, if it is a
+   * write, every further such write up to MAX_WRITE_BATCH. Caller should hold latch_.
+   */
+  auto TakeBatch() -> std::vector<DiskRequest>;
+
+  /** Execute a batch taken by TakeBatch() and fulfill its promises, with false for the pages that failed. */
+  void ProcessBatch(std::vector<DiskRequest> *batch);
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Requests that have been scheduled and not taken by a worker yet, in scheduling order. */
+  std::deque<DiskRequest> queue_;
+  /** Pages with a request being executed by a worker; later requests for them have to wait. */
+  std::unordered_set<page_id_t> in_progress_;
+  /** Protects queue_, in_progress_ and stop_. */
+  std::mutex latch_;
+  /** Signalled when a request is queued or a page leaves in_progress_. */
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+  /** See GetReadLatency() and GetWriteLatency(). */
+  LatencyHistogram read_latency_;
+  LatencyHistogram write_latency_;
+};
+
+}  // namespace bustub
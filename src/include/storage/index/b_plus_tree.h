@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <deque>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
@@ -53,6 +54,9 @@ public:
  // You may want to use this when getting value, but not necessary.
  std::deque<ReadPageGuard> read_set_;
 
+ // Pages unlinked from the tree by a remove. They are deleted once the guards are dropped, a pinned page can't be.
+ std::vector<page_id_t> deleted_pages_;
+
  auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
 };
 
@@ -119,6 +123,9 @@ public:
 private:
  //  auto GetLeafPageRead(const KeyType &key, Transaction *txn) -> const ReadPageGuard &;
 
+ // Helper method for GetValue: descend without latches, return nullopt if a writer got in the way
+ auto GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> std::optional<bool>;
+
  // Helper method for remove
  void Remove(const KeyType &key, Context &ctx, std::deque<int> &idxes, std::deque<page_id_t> &page_ids,
              page_id_t root_page_id, Transaction *txn);
@@ -127,6 +134,9 @@ private:
 
  auto Redistribute(InternalPage *left, InternalPage *right, bool left_to_right) -> KeyType;
 
+ // Delete the pages merged away by a removal, and the ones earlier removals could not delete
+ void DeletePages(const std::vector<page_id_t> &page_ids);
+
  /* Debug Routines for FREE!! */
  void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
 
@@ -148,6 +158,9 @@ private:
  int leaf_max_size_;
  int internal_max_size_;
  page_id_t header_page_id_;
+ std::mutex pending_deletes_latch_;
+ // Pages merged away that were still pinned, e.g. by an optimistic reader, when the removal tried to delete them
+ std::vector<page_id_t> pending_deletes_;
 };
 
 /**
@@ -13,6 +13,7 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -52,6 +53,8 @@ class IndexIterator {
   size_t cur_idx_;
   size_t cur_size_;
   const B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_ = nullptr;
+  /** Hints the leaves ahead of the iterator to the buffer pool. */
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
\ No newline at end of file
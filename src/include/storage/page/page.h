@@ -12,11 +12,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
 #include "common/config.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rwlatch.h"
 
 namespace bustub {
@@ -25,21 +27,38 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The pages of a buffer pool are its frames' metadata: they are kept in their own array, one cache line apart so that
+ * threads working on neighbouring frames don't share cache lines, and point into the pool's FrameArena for their data.
+ * The book-keeping fields are atomic, the buffer pool pins and unpins resident pages without taking any lock.
+ *
+ * Besides its latch, a page has a version counter that writers bump, so that readers can also read the page
+ * optimistically without latching it and validate afterwards that no writer got in the way.
  */
-class Page {
+class alignas(BUSTUB_CACHELINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
-    ResetMemory();
+  /** Constructor. Allocates the page data and zeros it out. */
+  Page() : data_(new char[BUSTUB_PAGE_SIZE]), owns_data_(true) { ResetMemory(); }
+
+  /**
+   * Constructor for a page whose data is owned by someone else, e.g. a frame of the buffer pool's arena. Zeros out
+   * the page data.
+   * @param data BUSTUB_PAGE_SIZE bytes that outlive the page
+   */
+  explicit Page(char *data) : data_(data), owns_data_(false) { ResetMemory(); }
+
+  DISALLOW_COPY_AND_MOVE(Page);
+
+  /** Destructor. Frees the page data if the page owns it. */
+  ~Page() {
+    if (owns_data_) {
+      delete[] data_;
+    }
   }
 
-  /** Default destructor. */
-  ~Page() { delete[] data_; }
-
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
 
@@ -52,9 +71,10 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
+  /** Acquire the page write latch. Makes the page version odd until WUnlatch(). */
   inline void WLatch() {
     rwlatch_.WLock();
+    version_.fetch_add(1);
     //    std::string log_info =
     //        "Thread " + std::to_string(pthread_self()) + ":acquired write latch for page_id " + std::to_string(GetPageId());
     //    LOG_DEBUG("%s", log_info.c_str());
@@ -65,6 +85,7 @@ class Page {
     //    std::string log_info =
     //        "Thread " + std::to_string(pthread_self()) + ":release write latch for page_id " + std::to_string(GetPageId());
     //    LOG_DEBUG("%s", log_info.c_str());
+    version_.fetch_add(1, std::memory_order_release);
     rwlatch_.WUnlock();
   }
 
@@ -74,6 +95,13 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * @return the page version, which changes every time the write latch is taken or released. It is odd while a
+   * writer holds the latch: a read of the page data without the latch saw a consistent page if the version was even
+   * before the read and is the same after it.
+   */
+  inline auto GetVersion() -> uint64_t { return version_.load(std::memory_order_acquire); }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -93,17 +121,25 @@ class Page {
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
   /** The actual data that is stored within a page. */
-  // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
-  // we store it as a ptr.
+  // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow of
+  // pages allocated on their own, and to let the buffer pool keep all its frames in one arena, we store it as a ptr.
   char *data_;
+  /** True if data_ was allocated by the page. */
+  bool owns_data_;
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /** The pin count of this page, -1 while the buffer pool is taking the frame for another page. */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
+  /** True while the buffer pool is reading the page in (or writing the previous occupant out) without its latch. */
+  std::atomic<bool> is_io_pending_ = false;
+  /** True if the page was read ahead and is still pinned for it, see BufferPoolManager::PrefetchPages(). */
+  std::atomic<bool> is_prefetched_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Version of the page data, bumped by WLatch() and WUnlatch(). */
+  std::atomic<uint64_t> version_ = 0;
 };
 
 }  // namespace bustub
\ No newline at end of file
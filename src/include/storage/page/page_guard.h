@@ -77,6 +77,7 @@ class BasicPageGuard {
  private:
   friend class ReadPageGuard;
   friend class WritePageGuard;
+  friend class OptimisticReadPageGuard;
 
   [[maybe_unused]] BufferPoolManager *bpm_{nullptr};
   Page *page_{nullptr};
@@ -202,4 +203,51 @@ class WritePageGuard {
   BasicPageGuard guard_;
 };
 
+/**
+ * OptimisticReadPageGuard keeps a page pinned and reads it without its latch. It records the page version when it is
+ * created, and Validate() tells whether a writer latched the page since: only then can what was read be trusted.
+ *
+ * A writer may change the page in the middle of the read, so the reader must not trust anything it reads before
+ * validating: every offset or size read from the page has to be checked against the page bounds before it is used,
+ * and page ids read from it must be validated before they are followed. A reader whose validation fails restarts,
+ * usually falling back to a ReadPageGuard after a few attempts.
+ */
+class OptimisticReadPageGuard {
+ public:
+  OptimisticReadPageGuard() = default;
+  OptimisticReadPageGuard(BufferPoolManager *bpm, Page *page);
+  OptimisticReadPageGuard(const OptimisticReadPageGuard &) = delete;
+  auto operator=(const OptimisticReadPageGuard &) -> OptimisticReadPageGuard & = delete;
+  OptimisticReadPageGuard(OptimisticReadPageGuard &&that) noexcept;
+  auto operator=(OptimisticReadPageGuard &&that) noexcept -> OptimisticReadPageGuard &;
+
+  /** @brief Unpin the page. There is no latch to release. */
+  void Drop();
+
+  ~OptimisticReadPageGuard();
+
+  /**
+   * @return true if no writer latched the page between the creation of the guard and this call, i.e. if everything
+   * read from the page in between is consistent
+   */
+  auto Validate() -> bool;
+
+  /** @return false if the page could not be fetched, e.g. because it was deleted */
+  auto IsValid() const -> bool { return guard_.page_ != nullptr; }
+
+  auto PageId() -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() -> const char * { return guard_.GetData(); }
+
+  template <class T>
+  auto As() -> const T * {
+    return guard_.As<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+  /** The page version when the guard was created. */
+  uint64_t version_{0};
+};
+
 }  // namespace bustub
@@ -24,6 +24,7 @@
 #include "storage/page/page.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
@@ -65,6 +66,9 @@ class TablePage {
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+  /** @return the size of the largest tuple that fits in this page */
+  auto GetFreeSpace() const -> size_t;
+
   /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
@@ -85,6 +89,11 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple from a table without copying it. The view points into the page, which the caller keeps latched.
+   */
+  auto GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView>;
+
   /**
    * Read a tuple meta from a table.
    */
@@ -95,6 +104,23 @@ class TablePage {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /** @return the bytes taken by deleted tuples whose space has not been reclaimed yet */
+  auto GetDeadSpace() const -> size_t;
+
+  /**
+   * @return the bytes Compact() would reclaim
+   * @param oldest_active_txn_id the oldest transaction that is still running
+   */
+  auto GetReclaimableSpace(txn_id_t oldest_active_txn_id) const -> size_t;
+
+  /**
+   * Reclaim the space of the tuples deleted by transactions older than oldest_active_txn_id, moving the other tuples
+   * together at the end of the page. Slots keep their number, reclaimed ones are left with no data.
+   * @param oldest_active_txn_id the oldest transaction that is still running
+   * @return the number of bytes reclaimed
+   */
+  auto Compact(txn_id_t oldest_active_txn_id) -> size_t;
+
   static_assert(sizeof(page_id_t) == 4);
 
  private:
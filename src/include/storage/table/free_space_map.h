@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks the pages of a table heap that have room for more tuples, and how much.
+ *
+ * A page is either in the map, available to any inserter, or taken by one inserter that fills it and then puts it back
+ * with what is left. Pages get into the map when an inserter is done with them, and when space is reclaimed on a page
+ * that was full. The map lives in memory only; a table heap starts out with an empty map.
+ */
+class FreeSpaceMap {
+ public:
+  /** Pages with less free space than this are not worth tracking. */
+  static constexpr size_t MIN_FREE_SPACE = 32;
+
+  /**
+   * @brief Record how much space a page has for new tuples, replacing what was recorded before. Pages with less than
+   * MIN_FREE_SPACE bytes are dropped from the map.
+   * @param free_space the largest tuple the page can take, see TablePage::GetFreeSpace()
+   */
+  void Update(page_id_t page_id, size_t free_space);
+
+  /**
+   * @brief Take the page with the least free space that still fits a tuple of the given size out of the map.
+   * @return the page, or INVALID_PAGE_ID if no page has room for the tuple
+   */
+  auto Take(size_t size) -> page_id_t;
+
+  /** @brief Forget a page, e.g. when it is removed from the table. */
+  void Remove(page_id_t page_id);
+
+  /** @return the number of pages in the map */
+  auto GetNumPages() -> size_t;
+
+  /** @return the free space of all the pages in the map, in bytes */
+  auto GetTotalFreeSpace() -> size_t;
+
+ private:
+  std::mutex latch_;
+  /** Pages ordered by free space. */
+  std::set<std::pair<size_t, page_id_t>> pages_;
+  std::unordered_map<page_id_t, size_t> free_space_;
+  size_t total_free_space_{0};
+};
+
+}  // namespace bustub
@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -22,14 +25,29 @@
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** What a TableHeap::Vacuum() pass found and did, in bytes of tuple data. */
+struct VacuumStats {
+  size_t num_pages_{0};
+  size_t num_compacted_pages_{0};
+  size_t reclaimed_bytes_{0};
+  /** Space of deleted tuples that some transaction may still bring back. */
+  size_t dead_bytes_{0};
+  /** Space left for new tuples. */
+  size_t free_bytes_{0};
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Inserts are spread over INSERT_STRIPES stripes by thread. Each stripe fills its own page, taken from the free space
+ * map or appended to the heap when no page has room, so that concurrent inserts do not wait for each other.
  */
 class TableHeap {
   friend class TableIterator;
@@ -44,6 +62,9 @@ class TableHeap {
    */
   explicit TableHeap(BufferPoolManager *bpm);
 
+  /** Number of pages that tuples are inserted into at the same time. */
+  static constexpr size_t INSERT_STRIPES = 8;
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
    * @param meta tuple meta
@@ -53,6 +74,20 @@ class TableHeap {
   auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr = nullptr,
                    Transaction *txn = nullptr, table_oid_t oid = 0) -> std::optional<RID>;
 
+  /**
+   * Insert a batch of tuples into new pages, which are filled in order and linked at the end of the table at once.
+   *
+   * Concurrent scans see either none or all of the batch. What is left of the last new page goes to the free space
+   * map. The tuples are row locked like in InsertTuple(), unless txn holds an exclusive lock on the whole table. If a
+   * lock cannot be taken, the new pages are deleted before the exception is passed on.
+   *
+   * @param meta tuple meta of all the tuples
+   * @param tuples tuples to insert, each of them has to fit in an empty page
+   * @return rids of the inserted tuples, in the order of tuples
+   */
+  auto BulkInsertTuples(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr = nullptr,
+                        Transaction *txn = nullptr, table_oid_t oid = 0) -> std::vector<RID>;
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
    * @param meta new tuple meta
@@ -63,9 +98,19 @@ class TableHeap {
   /**
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
+   * @param access_type type of access to the page, AccessType::Scan when called by a sequential scan
    * @return the meta and tuple
    */
-  auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
+  auto GetTuple(RID rid, AccessType access_type = AccessType::Unknown) -> std::pair<TupleMeta, Tuple>;
+
+  /**
+   * Read several tuples from the table, fetching all of their pages with one BufferPoolManager::FetchPages().
+   * @param rids rids of the tuples to read
+   * @param access_type type of access to the pages
+   * @return the meta and tuple of every rid, in the order of rids
+   */
+  auto GetTuples(const std::vector<RID> &rids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<std::pair<TupleMeta, Tuple>>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
@@ -84,6 +129,9 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the number of pages linked in this table */
+  inline auto GetNumPages() const -> size_t { return num_pages_; }
+
   /**
    * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4.
    * @param meta new tuple meta
@@ -92,12 +140,48 @@ class TableHeap {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Reclaim the space of deleted tuples in every page, see TablePage::Compact(). The reclaimed space goes to the free
+   * space map. Pages are write latched one at a time while they are compacted, scans and inserts go on.
+   *
+   * Tables are only read again if tuples have been deleted since their last vacuum, or if it left deleted tuples
+   * behind, otherwise the stats of the last vacuum are returned.
+   *
+   * @param oldest_active_txn_id the oldest transaction that is still running
+   */
+  auto Vacuum(txn_id_t oldest_active_txn_id) -> VacuumStats;
+
+  /** @return the pages of this table that have room for more tuples, besides those being filled by an inserter */
+  auto GetFreeSpaceMap() -> FreeSpaceMap & { return free_space_map_; }
+
  private:
+  /** A page that inserts of some threads fill, and the latch that makes them take turns. */
+  struct InsertStripe {
+    std::mutex latch_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /**
+   * Allocate a new page and link it at the end of the heap.
+   * @return the id of the new page
+   */
+  auto AppendPage() -> page_id_t;
+
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  std::atomic<size_t> num_pages_{1};        /* updated with latch_ held */
+
+  FreeSpaceMap free_space_map_;
+  std::array<InsertStripe, INSERT_STRIPES> insert_stripes_;
+
+  /** Set when a tuple is deleted, cleared when a vacuum starts. */
+  std::atomic<bool> needs_vacuum_{true};
+  /** Serializes vacuums. */
+  std::mutex vacuum_latch_;
+  VacuumStats last_vacuum_stats_; /* protected by vacuum_latch_ */
 };
 
 }  // namespace bustub
@@ -13,17 +13,23 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "buffer/read_ahead.h"
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
 class TableHeap;
+class TablePage;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
@@ -32,6 +38,9 @@ class TableIterator {
   friend class Cursor;
 
  public:
+  /** Decides which tuples a page-at-a-time scan keeps. It sees each tuple in place, with the page latched. */
+  using TupleFilter = std::function<bool(const TupleMeta &, const TupleView &)>;
+
   DISALLOW_COPY(TableIterator);
 
   TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
@@ -41,6 +50,28 @@ class TableIterator {
 
   auto GetTuple() -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * @brief Page-at-a-time scan: read the tuples from the current one to the end of its page with a single fetch of the
+   * page, and move to the next page. The next page is not fetched until it is read, so the iterator may come to rest
+   * on a page with no tuples left, which the next call reads as an empty batch; do not mix this with operator++.
+   * @param filter keeps the tuples for which it returns true, e.g. the visible ones that match a predicate
+   * @param[out] batch the tuples kept are copied out to it
+   * @param max_tuples read at most this many tuples, e.g. the ones GetPageRIDs() returned; the iterator then stays on
+   * the page if it has more
+   */
+  void NextPage(const TupleFilter &filter, std::vector<Tuple> *batch,
+                size_t max_tuples = std::numeric_limits<size_t>::max());
+
+  /** @return the RIDs of the tuples the next NextPage() call reads, e.g. to lock them before they are read */
+  auto GetPageRIDs() -> std::vector<RID>;
+
+  /**
+   * @brief Hand the tuples the next NextPage() call would read over to a new iterator, e.g. to read them on another
+   * thread, and move past them the same way.
+   * @return an iterator over these tuples only, which one NextPage() call reads
+   */
+  auto SplitPage(size_t max_tuples = std::numeric_limits<size_t>::max()) -> TableIterator;
+
   auto GetRID() -> RID;
 
   auto IsEnd() -> bool;
@@ -48,6 +79,24 @@ class TableIterator {
   auto operator++() -> TableIterator &;
 
  private:
+  /** An iterator over the slots [begin_slot, end_slot) of a page, see SplitPage(). */
+  TableIterator(TableHeap *table_heap, page_id_t page_id, uint32_t begin_slot, uint32_t end_slot);
+
+  /**
+   * Move rid_ past the pages that have no tuple at or after it, e.g. a page just appended by an inserter that has not
+   * filled it yet. rid_ becomes invalid at the end of the heap or at stop_at_rid_.
+   */
+  void SkipEmptyPages();
+
+  /** Report the page of rid_, whose successor is next_page_id, to read_ahead_. */
+  void HintReadAhead(page_id_t next_page_id);
+
+  /** @return the slot the scan of the page of rid_ ends at */
+  auto GetEndSlot(const TablePage *page) -> uint32_t;
+
+  /** Move rid_ to slot of its page, or past the page if that is the end of the scan of the page. */
+  void MoveTo(uint32_t slot, uint32_t end_slot, page_id_t next_page_id);
+
   TableHeap *table_heap_;
   RID rid_;
 
@@ -55,6 +104,9 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  /** Hints the pages ahead of the iterator to the buffer pool. */
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
@@ -52,6 +52,7 @@ class Tuple {
   friend class TablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -108,6 +109,9 @@ class Tuple {
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
+  // Get the starting storage address of specific column in serialized tuple data
+  static auto GetDataPtr(const char *data, const Schema *schema, uint32_t column_idx) -> const char *;
+
   RID rid_{};  // if pointing to the table heap, the rid is valid
   std::vector<char> data_;
 };
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.h
+//
+// Identification: src/include/storage/table/tuple_view.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleView reads a tuple in place on its table page, without copying it into a Tuple.
+ *
+ * A view points into its page, and is only valid while the page stays latched by whoever made it, e.g. while
+ * TableIterator::NextPage() hands it to a filter. Materialize() the tuples to keep.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  TupleView(RID rid, const char *data, uint32_t length) : rid_(rid), data_(data), length_(length) {}
+
+  inline auto GetRid() const -> RID { return rid_; }
+
+  /** @return the tuple data on the page */
+  inline auto GetData() const -> const char * { return data_; }
+
+  inline auto GetLength() const -> uint32_t { return length_; }
+
+  /** @return the value of a column, the same as Tuple::GetValue() on a copy of the tuple */
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  /** @return a copy of the tuple that outlives the view */
+  auto Materialize() const -> Tuple;
+
+ private:
+  RID rid_{};
+  const char *data_{nullptr};
+  uint32_t length_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_worker.h
+//
+// Identification: src/include/storage/table/vacuum_worker.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "common/metrics.h"
+#include "concurrency/transaction_manager.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * VacuumWorker reclaims the space of deleted tuples in all the tables of a catalog, so that inserts reuse it instead of
+ * growing the tables, see TableHeap::Vacuum().
+ *
+ * Passes run on a background thread once started, or on the caller's thread with RunOnce(). Space is only reclaimed
+ * once the transaction that deleted a tuple and all older ones have finished.
+ */
+class VacuumWorker {
+ public:
+  /**
+   * @param catalog the tables to vacuum
+   * @param catalog_lock held shared while the tables of the catalog are looked up, exclusive while tables are created
+   * @param txn_manager tells which transactions are still running
+   */
+  VacuumWorker(Catalog *catalog, std::shared_mutex *catalog_lock, TransactionManager *txn_manager);
+
+  ~VacuumWorker();
+
+  DISALLOW_COPY_AND_MOVE(VacuumWorker);
+
+  /**
+   * @brief Start the background thread, which vacuums all the tables every interval. Does nothing if it is already
+   * running.
+   */
+  void Start(std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+  /** @brief Stop the background thread, if running. */
+  void Stop();
+
+  /**
+   * @brief Vacuum all the tables once.
+   * @return what was found in each table, by table name
+   */
+  auto RunOnce() -> std::map<std::string, VacuumStats>;
+
+  /**
+   * @brief Append the statistics of the vacuum to metrics, as vacuum.runs, vacuum.reclaimed_bytes, ... and the bloat
+   * of each table as of its last vacuum, as vacuum.<table>.bloat_pct: the share of its pages not used by live tuples.
+   */
+  void AppendMetrics(MetricList *metrics);
+
+ private:
+  Catalog *catalog_;
+  std::shared_mutex *catalog_lock_;
+  TransactionManager *txn_manager_;
+
+  /** Serializes passes, and protects the statistics below. */
+  std::mutex latch_;
+  size_t num_runs_{0};
+  size_t num_compacted_pages_{0};
+  size_t reclaimed_bytes_{0};
+  std::map<std::string, VacuumStats> table_stats_;
+
+  /** The background thread, joinable while it runs. */
+  std::thread thread_;
+  /** Protects stop_. */
+  std::mutex thread_latch_;
+  std::condition_variable thread_cv_;
+  bool stop_ = false;
+};
+
+}  // namespace bustub
@@ -58,7 +58,8 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
             // Now it's in form of <column_expr> = <column_expr>. Let's match an index for them.
 
             // Ensure right child is table scan
-            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan) {
+            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan &&
+                dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan()).filter_predicate_ == nullptr) {
               const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
               if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
                 if (auto index = MatchIndex(right_seq_scan.table_name_, right_expr->GetColIdx());
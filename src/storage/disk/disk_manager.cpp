@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -20,6 +22,7 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -31,10 +34,34 @@ static char *buffer_used;
  * @input db_file: database file name
  */
 DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+  if (!OpenLogFile()) {
+    return;
+  }
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  if (!db_io_.is_open()) {
+    db_io_.clear();
+    // create a new file
+    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!db_io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+  buffer_used = nullptr;
+  LoadPageMap();
+}
+
+/**
+ * Open/create the log file next to the database file
+ * @return: false if the database file name has a wrong format
+ */
+auto DiskManager::OpenLogFile() -> bool {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
-    return;
+    return false;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
@@ -48,25 +75,17 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open dblog file");
     }
   }
-
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
-  }
-  buffer_used = nullptr;
+  return true;
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  if (db_io_.is_open()) {
+    ShrinkToFit();
+    SavePageMap();
+  }
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
@@ -93,6 +112,15 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   db_io_.flush();
 }
 
+/**
+ * Write consecutive pages one at a time
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data) {
+  for (size_t i = 0; i < pages_data.size(); i++) {
+    WritePage(first_page_id + static_cast<page_id_t>(i), pages_data[i]);
+  }
+}
+
 /**
  * Read the contents of the specified page into the given memory area
  */
@@ -199,6 +227,166 @@ auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
  */
 auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 
+/**
+ * Allocate the lowest free page of the class, or extend the database by a page
+ * of the class. The pages skipped to get to it become free pages.
+ */
+auto DiskManager::AllocatePage(size_t stride, size_t offset) -> page_id_t {
+  BUSTUB_ASSERT(offset < stride, "invalid page id class");
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  auto &free_pages = FreePagesOf(stride, offset);
+  if (!free_pages.empty()) {
+    auto page_id = *free_pages.begin();
+    free_pages.erase(free_pages.begin());
+    num_free_pages_--;
+    return page_id;
+  }
+
+  auto page_id = num_pages_ + static_cast<page_id_t>((offset + stride - num_pages_ % stride) % stride);
+  for (auto skipped_page_id = num_pages_; skipped_page_id < page_id; skipped_page_id++) {
+    FreePagesOf(stride, skipped_page_id % stride).insert(skipped_page_id);
+    num_free_pages_++;
+  }
+  num_pages_ = page_id + 1;
+  max_num_pages_ = std::max(max_num_pages_, num_pages_);
+  return page_id;
+}
+
+/**
+ * Put the page on the free list, then shorten the database by the free pages at
+ * its end
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  if (page_id < 0 || page_id >= num_pages_) {
+    return;
+  }
+  if (!free_pages_[page_id % free_pages_.size()].insert(page_id).second) {
+    return;
+  }
+  num_free_pages_++;
+  while (num_pages_ > 0 && free_pages_[(num_pages_ - 1) % free_pages_.size()].erase(num_pages_ - 1) != 0) {
+    num_free_pages_--;
+    num_pages_--;
+  }
+}
+
+auto DiskManager::IsAllocated(page_id_t page_id) -> bool {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  return page_id >= 0 && page_id < num_pages_ && free_pages_[page_id % free_pages_.size()].count(page_id) == 0;
+}
+
+auto DiskManager::GetNumPages() -> size_t {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  return num_pages_;
+}
+
+auto DiskManager::GetNumFreePages() -> size_t {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  return num_free_pages_;
+}
+
+/**
+ * Truncate the file after the last allocated page. Pages past max_num_pages_
+ * were written without being allocated, a file holding some is not ours to cut.
+ */
+auto DiskManager::ShrinkToFit() -> size_t {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  if (file_name_.empty()) {
+    return 0;
+  }
+  auto file_size = GetFileSize(file_name_);
+  if (file_size < 0) {
+    return 0;
+  }
+  auto file_pages = static_cast<page_id_t>((file_size + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE);
+  if (file_pages <= num_pages_ || file_pages > max_num_pages_) {
+    return 0;
+  }
+  if (truncate(file_name_.c_str(), static_cast<off_t>(num_pages_) * BUSTUB_PAGE_SIZE) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+    return 0;
+  }
+  return file_pages - num_pages_;
+}
+
+/**
+ * Page map format: the size of the database file when the map was saved (8),
+ * num_pages_ (4), max_num_pages_ (4), then one bit per page below num_pages_,
+ * set for the free pages. A map whose file size does not match the database
+ * file belongs to another incarnation of the file and is ignored.
+ */
+void DiskManager::LoadPageMap() {
+  page_map_name_ = file_name_.substr(0, file_name_.rfind('.')) + ".pagemap";
+  std::ifstream page_map_io(page_map_name_, std::ios::binary);
+  if (!page_map_io.is_open()) {
+    return;
+  }
+  int64_t file_size = 0;
+  page_id_t num_pages = 0;
+  page_id_t max_num_pages = 0;
+  page_map_io.read(reinterpret_cast<char *>(&file_size), sizeof(file_size));
+  page_map_io.read(reinterpret_cast<char *>(&num_pages), sizeof(num_pages));
+  page_map_io.read(reinterpret_cast<char *>(&max_num_pages), sizeof(max_num_pages));
+  if (!page_map_io || file_size <= 0 || file_size != GetFileSize(file_name_) || num_pages < 0 ||
+      max_num_pages < num_pages) {
+    LOG_DEBUG("ignoring stale page map %s", page_map_name_.c_str());
+    return;
+  }
+  std::vector<uint8_t> bitmap((num_pages + 7) / 8);
+  page_map_io.read(reinterpret_cast<char *>(bitmap.data()), static_cast<std::streamsize>(bitmap.size()));
+  if (!page_map_io) {
+    LOG_DEBUG("ignoring truncated page map %s", page_map_name_.c_str());
+    return;
+  }
+
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  num_pages_ = num_pages;
+  max_num_pages_ = max_num_pages;
+  free_pages_.assign(1, {});
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    if ((bitmap[page_id / 8] & (1 << (page_id % 8))) != 0) {
+      free_pages_[0].insert(page_id);
+    }
+  }
+  num_free_pages_ = free_pages_[0].size();
+}
+
+void DiskManager::SavePageMap() {
+  if (page_map_name_.empty()) {
+    return;
+  }
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  int64_t file_size = GetFileSize(file_name_);
+  std::vector<uint8_t> bitmap((num_pages_ + 7) / 8);
+  for (auto &free_pages : free_pages_) {
+    for (auto page_id : free_pages) {
+      bitmap[page_id / 8] |= 1 << (page_id % 8);
+    }
+  }
+  std::ofstream page_map_io(page_map_name_, std::ios::binary | std::ios::trunc);
+  page_map_io.write(reinterpret_cast<const char *>(&file_size), sizeof(file_size));
+  page_map_io.write(reinterpret_cast<const char *>(&num_pages_), sizeof(num_pages_));
+  page_map_io.write(reinterpret_cast<const char *>(&max_num_pages_), sizeof(max_num_pages_));
+  page_map_io.write(reinterpret_cast<const char *>(bitmap.data()), static_cast<std::streamsize>(bitmap.size()));
+  if (page_map_io.bad()) {
+    LOG_DEBUG("I/O error while writing page map");
+  }
+}
+
+auto DiskManager::FreePagesOf(size_t stride, size_t offset) -> std::set<page_id_t> & {
+  if (free_pages_.size() != stride) {
+    std::vector<std::set<page_id_t>> free_pages(stride);
+    for (auto &pages : free_pages_) {
+      for (auto page_id : pages) {
+        free_pages[page_id % stride].insert(page_id);
+      }
+    }
+    free_pages_ = std::move(free_pages);
+  }
+  return free_pages_[offset];
+}
+
 /**
  * Private helper function to get disk file size
  */
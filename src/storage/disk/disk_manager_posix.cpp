@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return true if the buffer can be handed to an O_DIRECT read or write as is */
+auto IsAligned(const char *data) -> bool { return reinterpret_cast<uintptr_t>(data) % BUSTUB_PAGE_SIZE == 0; }
+
+/** @return a BUSTUB_PAGE_SIZE aligned buffer owned by the calling thread, used to bounce unaligned O_DIRECT I/O */
+auto BounceBuffer() -> char * {
+  struct AlignedFree {
+    void operator()(char *data) const { free(data); }  // NOLINT
+  };
+  thread_local std::unique_ptr<char, AlignedFree> buffer(
+      static_cast<char *>(aligned_alloc(BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE)));
+  return buffer.get();
+}
+
+}  // namespace
+
+/**
+ * Constructor: open/create the database file for positional I/O & the log file
+ */
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file, bool direct_io) {
+  file_name_ = db_file;
+  if (!OpenLogFile()) {
+    return;
+  }
+
+#ifdef O_DIRECT
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ >= 0) {
+      direct_io_ = true;
+    } else {
+      LOG_DEBUG("O_DIRECT is not supported for %s, using buffered I/O", db_file.c_str());
+    }
+  }
+#endif
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  LoadPageMap();
+}
+
+DiskManagerPosix::~DiskManagerPosix() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
+/**
+ * Close the database file & the log file
+ */
+void DiskManagerPosix::ShutDown() {
+  if (db_fd_ >= 0) {
+    ShrinkToFit();
+    SavePageMap();
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+/**
+ * Write the contents of the specified page into disk file
+ */
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  off_t offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += 1;
+  if (direct_io_ && !IsAligned(page_data)) {
+    auto *buffer = BounceBuffer();
+    memcpy(buffer, page_data, BUSTUB_PAGE_SIZE);
+    page_data = buffer;
+  }
+  if (pwrite(db_fd_, page_data, BUSTUB_PAGE_SIZE, offset) != BUSTUB_PAGE_SIZE) {
+    LOG_DEBUG("I/O error while writing");
+  }
+}
+
+/**
+ * Write consecutive pages with as few pwritev calls as possible
+ */
+void DiskManagerPosix::WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data) {
+  if (direct_io_ && !std::all_of(pages_data.begin(), pages_data.end(), IsAligned)) {
+    // every buffer of an O_DIRECT pwritev has to be aligned, bounce the pages one at a time
+    DiskManager::WritePages(first_page_id, pages_data);
+    return;
+  }
+
+  std::vector<iovec> iov(std::min<size_t>(pages_data.size(), IOV_MAX));
+  for (size_t start = 0; start < pages_data.size(); start += iov.size()) {
+    size_t count = std::min(iov.size(), pages_data.size() - start);
+    for (size_t i = 0; i < count; i++) {
+      iov[i].iov_base = const_cast<char *>(pages_data[start + i]);  // NOLINT
+      iov[i].iov_len = BUSTUB_PAGE_SIZE;
+    }
+    off_t offset = static_cast<off_t>(first_page_id + static_cast<page_id_t>(start)) * BUSTUB_PAGE_SIZE;
+    num_writes_ += static_cast<int>(count);
+    auto expected = static_cast<ssize_t>(count * BUSTUB_PAGE_SIZE);
+    if (pwritev(db_fd_, iov.data(), static_cast<int>(count), offset) != expected) {
+      LOG_DEBUG("I/O error while writing");
+    }
+  }
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) {
+  off_t offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  char *buffer = direct_io_ && !IsAligned(page_data) ? BounceBuffer() : page_data;
+  auto read_count = pread(db_fd_, buffer, BUSTUB_PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading");
+    return;
+  }
+  if (read_count < BUSTUB_PAGE_SIZE) {
+    // reading past the end of the file
+    memset(buffer + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+  }
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, BUSTUB_PAGE_SIZE);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,329 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define BUSTUB_HAS_IO_URING 1
+#endif
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, uint32_t queue_depth) : DiskManagerPosix(db_file) {
+  if (db_fd_ < 0) {
+    return;
+  }
+
+  SetUpRing(queue_depth);
+  if (IsAsync()) {
+    reaper_ = std::thread([this] { ReapCompletions(); });
+  } else {
+    LOG_DEBUG("io_uring is not available, falling back to synchronous I/O");
+  }
+}
+
+DiskManagerUring::~DiskManagerUring() { ShutDown(); }
+
+#ifdef BUSTUB_HAS_IO_URING
+
+void DiskManagerUring::SetUpRing(uint32_t queue_depth) {
+  io_uring_params params{};
+  int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+  if (ring_fd < 0) {
+    return;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ptr_ =
+      mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ptr_ == MAP_FAILED) {
+    sq_ring_ptr_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+  if (single_mmap) {
+    cq_ring_ptr_ = sq_ring_ptr_;
+  } else {
+    cq_ring_ptr_ =
+        mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ptr_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (cq_ring_ptr_ == MAP_FAILED || sqes_ptr_ == MAP_FAILED) {
+    if (cq_ring_ptr_ != MAP_FAILED && !single_mmap) {
+      munmap(cq_ring_ptr_, cq_ring_size_);
+    }
+    if (sqes_ptr_ != MAP_FAILED) {
+      munmap(sqes_ptr_, sqes_size_);
+    }
+    munmap(sq_ring_ptr_, sq_ring_size_);
+    sq_ring_ptr_ = cq_ring_ptr_ = sqes_ptr_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+
+  auto *sq = static_cast<char *>(sq_ring_ptr_);
+  sq_head_ = reinterpret_cast<uint32_t *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+  sq_array_ = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+  sq_mask_ = *reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+
+  auto *cq = static_cast<char *>(cq_ring_ptr_);
+  cq_head_ = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+  cqes_ = cq + params.cq_off.cqes;
+  cq_mask_ = *reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+
+  ring_fd_ = ring_fd;
+}
+
+auto DiskManagerUring::Enqueue(bool is_write, page_id_t page_id, char *page_data) -> std::future<bool> {
+  std::unique_lock<std::mutex> lock(sq_latch_);
+  // Bound the requests in flight by the submission queue size, so that the completion queue (twice as large) can
+  // never overflow and a free submission entry always exists. If the ring is full, hand the queued entries over to
+  // the kernel first, otherwise nothing would ever complete.
+  if (inflight_.size() >= sq_entries_) {
+    SubmitLocked();
+    sq_cv_.wait(lock, [this] { return inflight_.size() < sq_entries_; });
+  }
+  if (failed_) {
+    lock.unlock();
+    return RequestSync(is_write, page_id, page_data);
+  }
+  if (is_write) {
+    num_writes_ += 1;
+  }
+
+  uint32_t tail = *sq_tail_;
+  uint32_t index = tail & sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_ptr_) + index;
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  uint64_t request_id = next_request_id_++;
+  sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = db_fd_;
+  sqe->off = static_cast<uint64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  sqe->addr = reinterpret_cast<uint64_t>(page_data);
+  sqe->len = BUSTUB_PAGE_SIZE;
+  sqe->user_data = request_id;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  to_submit_++;
+
+  auto &request = inflight_[request_id];
+  request.read_data_ = is_write ? nullptr : page_data;
+  return request.promise_.get_future();
+}
+
+void DiskManagerUring::SubmitLocked() {
+  while (to_submit_ > 0) {
+    auto submitted = syscall(__NR_io_uring_enter, ring_fd_, to_submit_, 0, 0, nullptr, 0);
+    if (submitted < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      LOG_WARN("io_uring_enter failed: %s", strerror(errno));
+      FailQueuedLocked();
+      break;
+    }
+    to_submit_ -= static_cast<uint32_t>(submitted);
+  }
+  reap_cv_.notify_one();
+}
+
+void DiskManagerUring::FailQueuedLocked() {
+  // The kernel has not consumed the entries between its head and the tail, take them back off the ring.
+  uint32_t head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  uint32_t tail = *sq_tail_;
+  for (uint32_t i = head; i != tail; i++) {
+    auto *sqe = static_cast<io_uring_sqe *>(sqes_ptr_) + (i & sq_mask_);
+    auto it = inflight_.find(sqe->user_data);
+    if (it != inflight_.end()) {
+      it->second.promise_.set_value(false);
+      inflight_.erase(it);
+    }
+  }
+  __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+  to_submit_ = 0;
+  sq_cv_.notify_all();
+}
+
+void DiskManagerUring::ReapCompletions() {
+  while (true) {
+    {
+      // Only wait in the kernel while it has requests, so that ShutDown() can stop the reaper without submitting one.
+      std::unique_lock<std::mutex> lock(sq_latch_);
+      reap_cv_.wait(lock, [this] { return stop_ || inflight_.size() > to_submit_; });
+      if (inflight_.size() == to_submit_) {
+        return;
+      }
+    }
+
+    uint32_t head = *cq_head_;
+    uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      auto rc = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (rc < 0 && errno != EINTR) {
+        // Nothing would complete the requests in the kernel anymore. Fail them all and serve the next requests
+        // synchronously.
+        LOG_WARN("io_uring_enter failed while waiting, stopping io_uring: %s", strerror(errno));
+        std::unique_lock<std::mutex> lock(sq_latch_);
+        FailQueuedLocked();
+        for (auto &[request_id, request] : inflight_) {
+          request.promise_.set_value(false);
+        }
+        inflight_.clear();
+        failed_ = true;
+        lock.unlock();
+        sq_cv_.notify_all();
+        return;
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sq_latch_);
+    for (; head != tail; head++) {
+      auto *cqe = static_cast<io_uring_cqe *>(cqes_) + (head & cq_mask_);
+      auto it = inflight_.find(cqe->user_data);
+      if (it == inflight_.end()) {
+        continue;
+      }
+      bool ok = cqe->res >= 0;
+      if (!ok) {
+        LOG_DEBUG("I/O error in io_uring request: %s", strerror(-cqe->res));
+      } else if (it->second.read_data_ != nullptr && cqe->res < BUSTUB_PAGE_SIZE) {
+        // reading past the end of the file, same as DiskManager::ReadPage
+        memset(it->second.read_data_ + cqe->res, 0, BUSTUB_PAGE_SIZE - cqe->res);
+      } else if (it->second.read_data_ == nullptr && cqe->res < BUSTUB_PAGE_SIZE) {
+        LOG_DEBUG("short write in io_uring request");
+        ok = false;
+      }
+      it->second.promise_.set_value(ok);
+      inflight_.erase(it);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    lock.unlock();
+    sq_cv_.notify_all();
+  }
+}
+
+void DiskManagerUring::ShutDown() {
+  if (IsAsync()) {
+    {
+      std::unique_lock<std::mutex> lock(sq_latch_);
+      SubmitLocked();
+      sq_cv_.wait(lock, [this] { return inflight_.empty(); });
+      stop_ = true;
+    }
+    reap_cv_.notify_all();
+    reaper_.join();
+
+    munmap(sqes_ptr_, sqes_size_);
+    if (cq_ring_ptr_ != sq_ring_ptr_) {
+      munmap(cq_ring_ptr_, cq_ring_size_);
+    }
+    munmap(sq_ring_ptr_, sq_ring_size_);
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+  DiskManagerPosix::ShutDown();
+}
+
+#else
+
+void DiskManagerUring::SetUpRing(uint32_t queue_depth) {}
+
+auto DiskManagerUring::Enqueue(bool is_write, page_id_t page_id, char *page_data) -> std::future<bool> {
+  UNREACHABLE("io_uring is not supported on this platform");
+}
+
+void DiskManagerUring::SubmitLocked() {}
+
+void DiskManagerUring::FailQueuedLocked() {}
+
+void DiskManagerUring::ReapCompletions() {}
+
+void DiskManagerUring::ShutDown() { DiskManagerPosix::ShutDown(); }
+
+#endif
+
+auto DiskManagerUring::RequestSync(bool is_write, page_id_t page_id, char *page_data) -> std::future<bool> {
+  std::promise<bool> promise;
+  if (is_write) {
+    DiskManagerPosix::WritePage(page_id, page_data);
+  } else {
+    DiskManagerPosix::ReadPage(page_id, page_data);
+  }
+  promise.set_value(true);
+  return promise.get_future();
+}
+
+auto DiskManagerUring::ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool> {
+  if (!IsAsync()) {
+    return RequestSync(false, page_id, page_data);
+  }
+  return Enqueue(false, page_id, page_data);
+}
+
+auto DiskManagerUring::WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool> {
+  // The buffer is only read by a write request.
+  auto data = const_cast<char *>(page_data);  // NOLINT
+  if (!IsAsync()) {
+    return RequestSync(true, page_id, data);
+  }
+  return Enqueue(true, page_id, data);
+}
+
+void DiskManagerUring::Submit() {
+  if (!IsAsync()) {
+    return;
+  }
+  std::scoped_lock lock(sq_latch_);
+  SubmitLocked();
+}
+
+void DiskManagerUring::ReadPage(page_id_t page_id, char *page_data) {
+  auto future = ReadPageAsync(page_id, page_data);
+  Submit();
+  if (!future.get()) {
+    throw Exception("I/O error while reading page " + std::to_string(page_id));
+  }
+}
+
+void DiskManagerUring::WritePage(page_id_t page_id, const char *page_data) {
+  auto future = WritePageAsync(page_id, page_data);
+  Submit();
+  if (!future.get()) {
+    throw Exception("I/O error while writing page " + std::to_string(page_id));
+  }
+}
+
+}  // namespace bustub
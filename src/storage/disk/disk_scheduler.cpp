@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ENSURE(num_workers > 0, "disk scheduler needs at least one worker");
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([&] { StartWorkerThread(); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  {
+    std::scoped_lock lock(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) {
+  {
+    std::scoped_lock lock(latch_);
+    queue_.emplace_back(std::move(r));
+  }
+  cv_.notify_one();
+}
+
+void DiskScheduler::Schedule(std::vector<DiskRequest> requests) {
+  {
+    std::scoped_lock lock(latch_);
+    for (auto &r : requests) {
+      queue_.emplace_back(std::move(r));
+    }
+  }
+  cv_.notify_all();
+}
+
+void DiskScheduler::StartWorkerThread() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    std::vector<DiskRequest> batch;
+    cv_.wait(lock, [&] {
+      batch = TakeBatch();
+      return !batch.empty() || (stop_ && queue_.empty());
+    });
+    if (batch.empty()) {
+      return;
+    }
+
+    lock.unlock();
+    ProcessBatch(&batch);
+    lock.lock();
+    for (const auto &r : batch) {
+      in_progress_.erase(r.page_id_);
+    }
+    // Requests queued behind the pages of this batch may be taken now.
+    cv_.notify_all();
+  }
+}
+
+auto DiskScheduler::TakeBatch() -> std::vector<DiskRequest> {
+  std::vector<DiskRequest> batch;
+  // Pages of requests passed over in this scan; later requests for them must not overtake them.
+  std::unordered_set<page_id_t> skipped;
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    auto page_id = it->page_id_;
+    bool blocked = in_progress_.count(page_id) > 0 || skipped.count(page_id) > 0;
+    if (blocked || (!batch.empty() && !it->is_write_)) {
+      skipped.insert(page_id);
+      ++it;
+      continue;
+    }
+    in_progress_.insert(page_id);
+    batch.emplace_back(std::move(*it));
+    it = queue_.erase(it);
+    if (!batch.front().is_write_ || batch.size() == MAX_WRITE_BATCH) {
+      break;
+    }
+  }
+  return batch;
+}
+
+void DiskScheduler::ProcessBatch(std::vector<DiskRequest> *batch) {
+  if (!batch->front().is_write_) {
+    auto &r = batch->front();
+    auto start = std::chrono::steady_clock::now();
+    bool ok = true;
+    try {
+      disk_manager_->ReadPage(r.page_id_, r.data_);
+    } catch (const std::exception &e) {
+      LOG_DEBUG("read of page %d failed: %s", r.page_id_, e.what());
+      ok = false;
+    }
+    read_latency_.RecordSince(start);
+    r.callback_.set_value(ok);
+    return;
+  }
+
+  // The page ids in a batch are distinct, so every run of adjacent ids can be written with one call.
+  std::sort(batch->begin(), batch->end(), [](const auto &a, const auto &b) { return a.page_id_ < b.page_id_; });
+  std::vector<const char *> pages_data;
+  for (size_t start = 0; start < batch->size();) {
+    size_t end = start + 1;
+    while (end < batch->size() && (*batch)[end].page_id_ == (*batch)[end - 1].page_id_ + 1) {
+      ++end;
+    }
+    auto write_start = std::chrono::steady_clock::now();
+    bool ok = true;
+    try {
+      if (end - start == 1) {
+        disk_manager_->WritePage((*batch)[start].page_id_, (*batch)[start].data_);
+      } else {
+        pages_data.clear();
+        for (size_t i = start; i < end; ++i) {
+          pages_data.push_back((*batch)[i].data_);
+        }
+        disk_manager_->WritePages((*batch)[start].page_id_, pages_data);
+      }
+    } catch (const std::exception &e) {
+      // Only the pages of this run are failed, the other runs of the batch are written on their own.
+      LOG_DEBUG("write of pages %d-%d failed: %s", (*batch)[start].page_id_, (*batch)[end - 1].page_id_, e.what());
+      ok = false;
+    }
+    write_latency_.RecordSince(write_start);
+    for (size_t i = start; i < end; ++i) {
+      (*batch)[i].callback_.set_value(ok);
+    }
+    start = end;
+  }
+}
+
+}  // namespace bustub
@@ -50,6 +50,13 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   std::string loginfo = "Search for key: " + std::to_string(key.ToString());
   LOG_DEBUG("%s", loginfo.c_str());
 
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; ++attempt) {
+    auto found = GetValueOptimistic(key, result);
+    if (found.has_value()) {
+      return *found;
+    }
+  }
+
   if (IsEmpty()) {
     return false;
   }
@@ -79,6 +86,62 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return false;
 }
 
+/*
+ * Search for the key without latching the pages on the way down. Each page id
+ * is only followed once the page it was read from validated, and a page is
+ * only left behind once the version of the next one is taken, so that a split
+ * or merge of the next page, done with its parent latched, is noticed.
+ * @return : nullopt if a writer got in the way and the search must restart,
+ * otherwise whether the key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> std::optional<bool> {
+  OptimisticReadPageGuard guard = bpm_->FetchPageOptimistic(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (!guard.Validate()) {
+    return std::nullopt;
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  while (true) {
+    // A page deleted by a merge since its id was read is not fetched at all.
+    OptimisticReadPageGuard next_guard = bpm_->FetchPageOptimistic(page_id);
+    if (!guard.Validate() || !next_guard.IsValid()) {
+      return std::nullopt;
+    }
+    guard = std::move(next_guard);
+
+    // The page may be torn, make sure the search stays within it.
+    auto node = guard.As<BPlusTreePage>();
+    int size = node->GetSize();
+    if (node->IsLeafPage()) {
+      if (size < 0 || size > leaf_max_size_) {
+        return std::nullopt;
+      }
+      ValueType value;
+      bool found = guard.As<LeafPage>()->GetValue(key, &value, comparator_);
+      if (!guard.Validate()) {
+        return std::nullopt;
+      }
+      if (found) {
+        result->push_back(value);
+      }
+      return found;
+    }
+
+    if (size <= 0 || size > internal_max_size_) {
+      return std::nullopt;
+    }
+    auto inner_node = guard.As<InternalPage>();
+    page_id = inner_node->ValueAt(inner_node->KeyIndex(key, comparator_));
+    if (!guard.Validate()) {
+      return std::nullopt;
+    }
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -325,6 +388,24 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
   }
 
   Remove(key, ctx, inner_ids, page_ids, root_page_id, txn);
+
+  ctx.header_page_ = std::nullopt;
+  ctx.write_set_.clear();
+  DeletePages(ctx.deleted_pages_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePages(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock lock(pending_deletes_latch_);
+  auto pending = std::move(pending_deletes_);
+  pending_deletes_.clear();
+  pending.insert(pending.end(), page_ids.begin(), page_ids.end());
+  // An optimistic reader may pin a page for a moment after it left the tree, try again with the next removal.
+  for (auto page_id : pending) {
+    if (!bpm_->DeletePage(page_id)) {
+      pending_deletes_.push_back(page_id);
+    }
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -345,7 +426,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Context &ctx, std::deque<int> &i
       if (leaf->GetSize() == 0) {
         auto header = ctx.header_page_->template AsMut<BPlusTreeHeaderPage>();
         header->root_page_id_ = INVALID_PAGE_ID;
-        bpm_->DeletePage(root_page_id);
+        ctx.deleted_pages_.push_back(root_page_id);
       }
     } else {
       int cur_size = leaf->GetSize();
@@ -363,6 +444,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Context &ctx, std::deque<int> &i
               pre_page->InsertAtBack(cur_page->PairAt(i));
             }
             pre_page->SetNextPageId(cur_page->GetNextPageId());
+            ctx.deleted_pages_.push_back(cur_page_id);
 
             idxes.pop_back();
             page_ids.pop_back();
@@ -385,6 +467,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Context &ctx, std::deque<int> &i
               cur_page->InsertAtBack(next_page->PairAt(i));
             }
             cur_page->SetNextPageId(next_page->GetNextPageId());
+            ctx.deleted_pages_.push_back(next_page_id);
 
             idxes.pop_back();
             page_ids.pop_back();
@@ -407,7 +490,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Context &ctx, std::deque<int> &i
       if (internal->GetSize() == 1) {
         auto header = ctx.header_page_->template AsMut<BPlusTreeHeaderPage>();
         header->root_page_id_ = internal->ValueAt(0);
-        bpm_->DeletePage(cur_page_id);
+        ctx.deleted_pages_.push_back(cur_page_id);
         return;
       }
     } else {
@@ -425,6 +508,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Context &ctx, std::deque<int> &i
             for (int i = 0; i < cur_size; ++i) {
               pre_page->InsertAtBack(cur_page->PairAt(i));
             }
+            ctx.deleted_pages_.push_back(cur_page_id);
             idxes.pop_back();
             page_ids.pop_back();
             ctx.write_set_.pop_back();
@@ -445,6 +529,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Context &ctx, std::deque<int> &i
             for (int i = 0; i < next_size; ++i) {
               cur_page->InsertAtBack(next_page->PairAt(i));
             }
+            ctx.deleted_pages_.push_back(next_page_id);
             idxes.pop_back();
             page_ids.pop_back();
             ctx.write_set_.pop_back();
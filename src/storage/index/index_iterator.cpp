@@ -15,11 +15,13 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard *r_guard, int idx, page_id_t page_id,
                                  int cur_size)
-   : bpm_(bpm), page_id_(page_id), cur_idx_(idx), cur_size_(cur_size) {
+   : bpm_(bpm), page_id_(page_id), cur_idx_(idx), cur_size_(cur_size), read_ahead_(bpm) {
  if (r_guard == nullptr) {
    r_guard_ = std::nullopt;
  } else {
    r_guard_.emplace(std::move(*r_guard));
+   leaf_ = r_guard_->As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+   read_ahead_.OnPage(page_id_, leaf_->GetNextPageId());
  }
 }
 
@@ -33,7 +35,8 @@ INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&that) noexcept
      page_id_(that.page_id_),
      cur_idx_(that.cur_idx_),
      cur_size_(that.cur_size_),
-     leaf_(that.leaf_) {}
+     leaf_(that.leaf_),
+     read_ahead_(that.read_ahead_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator=(IndexIterator &&that) noexcept -> IndexIterator & {
@@ -44,6 +47,7 @@ auto INDEXITERATOR_TYPE::operator=(IndexIterator &&that) noexcept -> IndexIterat
    cur_idx_ = that.cur_idx_;
    cur_size_ = that.cur_size_;
    leaf_ = that.leaf_;
+   read_ahead_ = that.read_ahead_;
  }
  return *this;
 }
@@ -75,6 +79,7 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
      r_guard_.emplace(std::move(next_guard));
      leaf_ = r_guard_->As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
      cur_size_ = leaf_->GetSize();
+     read_ahead_.OnPage(page_id_, leaf_->GetNextPageId());
    }
    cur_idx_ = 0;
  }
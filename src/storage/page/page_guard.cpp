@@ -74,4 +74,34 @@ void WritePageGuard::Drop() {
 
 WritePageGuard::~WritePageGuard() { Drop(); }  // NOLINT
 
+OptimisticReadPageGuard::OptimisticReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {
+  if (page != nullptr) {
+    version_ = page->GetVersion();
+  }
+}
+
+OptimisticReadPageGuard::OptimisticReadPageGuard(OptimisticReadPageGuard &&that) noexcept
+    : guard_(std::move(that.guard_)), version_(that.version_) {}
+
+auto OptimisticReadPageGuard::operator=(OptimisticReadPageGuard &&that) noexcept -> OptimisticReadPageGuard & {
+  if (this != &that) {
+    guard_ = std::move(that.guard_);
+    version_ = that.version_;
+  }
+  return *this;
+}
+
+void OptimisticReadPageGuard::Drop() { guard_.Drop(); }
+
+OptimisticReadPageGuard::~OptimisticReadPageGuard() { Drop(); }  // NOLINT
+
+auto OptimisticReadPageGuard::Validate() -> bool {
+  if (guard_.page_ == nullptr || version_ % 2 != 0) {
+    return false;
+  }
+  // Keep the reads of the page data from being reordered after the second read of the version.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return guard_.page_->GetVersion() == version_;
+}
+
 }  // namespace bustub
\ No newline at end of file
@@ -28,20 +28,19 @@ void TablePage::Init() {
   num_deleted_tuples_ = 0;
 }
 
-auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
-  size_t slot_end_offset;
-  if (num_tuples_ > 0) {
-    auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
-    slot_end_offset = offset;
-  } else {
-    slot_end_offset = BUSTUB_PAGE_SIZE;
-  }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
+auto TablePage::GetFreeSpace() const -> size_t {
+  size_t slot_end_offset = num_tuples_ > 0 ? std::get<0>(tuple_info_[num_tuples_ - 1]) : BUSTUB_PAGE_SIZE;
   auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
-  if (tuple_offset < offset_size) {
+  return slot_end_offset < offset_size ? 0 : slot_end_offset - offset_size;
+}
+
+auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
+  // the tuple is written right before the last one, checking the space first as the offset would wrap around.
+  if (tuple.GetLength() > GetFreeSpace()) {
     return std::nullopt;
   }
-  return tuple_offset;
+  size_t slot_end_offset = num_tuples_ > 0 ? std::get<0>(tuple_info_[num_tuples_ - 1]) : BUSTUB_PAGE_SIZE;
+  return slot_end_offset - tuple.GetLength();
 }
 
 auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
@@ -73,7 +72,11 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   if (tuple_id >= num_tuples_) {
     throw bustub::Exception("Tuple ID out of range");
   }
-  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  // Copy the slot, the page may be read without its latch by an optimistic reader.
+  auto [offset, size, meta] = tuple_info_[tuple_id];
+  if (offset + size > BUSTUB_PAGE_SIZE) {
+    throw bustub::Exception("Tuple out of page bounds");
+  }
   Tuple tuple;
   tuple.data_.resize(size);
   memmove(tuple.data_.data(), page_start_ + offset, size);
@@ -81,6 +84,15 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TablePage::GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &[offset, size, meta] = tuple_info_[tuple_id];
+  return std::make_pair(meta, TupleView(rid, page_start_ + offset, size));
+}
+
 auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
@@ -90,6 +102,53 @@ auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   return meta;
 }
 
+auto TablePage::GetDeadSpace() const -> size_t {
+  size_t dead_space = 0;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (meta.is_deleted_) {
+      dead_space += size;
+    }
+  }
+  return dead_space;
+}
+
+/** A deleted tuple can be reclaimed once its deleter is gone, it is not brought back by an abort anymore. Tuples deleted
+ * outside of a transaction have an invalid deleter, smaller than any transaction id. */
+static auto IsReclaimable(const TupleMeta &meta, txn_id_t oldest_active_txn_id) -> bool {
+  return meta.is_deleted_ && meta.delete_txn_id_ < oldest_active_txn_id;
+}
+
+auto TablePage::GetReclaimableSpace(txn_id_t oldest_active_txn_id) const -> size_t {
+  size_t reclaimable_space = 0;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (IsReclaimable(meta, oldest_active_txn_id)) {
+      reclaimable_space += size;
+    }
+  }
+  return reclaimable_space;
+}
+
+auto TablePage::Compact(txn_id_t oldest_active_txn_id) -> size_t {
+  // Tuples are stored from the end of the page in slot order, each one moves towards the end by the space reclaimed
+  // before it, and never over a tuple that has not moved yet.
+  size_t reclaimed = 0;
+  size_t tuple_end = BUSTUB_PAGE_SIZE;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (IsReclaimable(meta, oldest_active_txn_id)) {
+      reclaimed += size;
+      size = 0;
+    } else if (offset + size != tuple_end) {
+      memmove(page_start_ + tuple_end - size, page_start_ + offset, size);
+    }
+    offset = tuple_end - size;
+    tuple_end = offset;
+  }
+  return reclaimed;
+}
+
 void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
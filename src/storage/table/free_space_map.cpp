@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+namespace bustub {
+
+void FreeSpaceMap::Update(page_id_t page_id, size_t free_space) {
+  std::scoped_lock lock(latch_);
+  auto it = free_space_.find(page_id);
+  if (it != free_space_.end()) {
+    pages_.erase({it->second, page_id});
+    total_free_space_ -= it->second;
+    free_space_.erase(it);
+  }
+  if (free_space >= MIN_FREE_SPACE) {
+    pages_.emplace(free_space, page_id);
+    free_space_.emplace(page_id, free_space);
+    total_free_space_ += free_space;
+  }
+}
+
+auto FreeSpaceMap::Take(size_t size) -> page_id_t {
+  std::scoped_lock lock(latch_);
+  auto it = pages_.lower_bound({size, INVALID_PAGE_ID});
+  if (it == pages_.end()) {
+    return INVALID_PAGE_ID;
+  }
+  auto [free_space, page_id] = *it;
+  pages_.erase(it);
+  free_space_.erase(page_id);
+  total_free_space_ -= free_space;
+  return page_id;
+}
+
+void FreeSpaceMap::Remove(page_id_t page_id) { Update(page_id, 0); }
+
+auto FreeSpaceMap::GetNumPages() -> size_t {
+  std::scoped_lock lock(latch_);
+  return pages_.size();
+}
+
+auto FreeSpaceMap::GetTotalFreeSpace() -> size_t {
+  std::scoped_lock lock(latch_);
+  return total_free_space_;
+}
+
+}  // namespace bustub
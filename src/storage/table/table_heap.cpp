@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "common/config.h"
@@ -34,71 +37,266 @@ TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init();
+  free_space_map_.Update(first_page_id_, first_page->GetFreeSpace());
 }
 
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
-  std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
-  while (true) {
-    auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
-      break;
+  auto &stripe = insert_stripes_[std::hash<std::thread::id>{}(std::this_thread::get_id()) % INSERT_STRIPES];
+  std::unique_lock<std::mutex> guard(stripe.latch_);
+  WritePageGuard page_guard;
+  if (stripe.page_id_ != INVALID_PAGE_ID) {
+    page_guard = bpm_->FetchPageWrite(stripe.page_id_);
+  }
+  while (stripe.page_id_ == INVALID_PAGE_ID ||
+         page_guard.As<TablePage>()->GetNextTupleOffset(meta, tuple) == std::nullopt) {
+    if (stripe.page_id_ != INVALID_PAGE_ID) {
+      auto page = page_guard.As<TablePage>();
+      // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
+      BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+      // Smaller tuples may still fit in what is left of the page.
+      free_space_map_.Update(stripe.page_id_, page->GetFreeSpace());
+      page_guard.Drop();
     }
+    stripe.page_id_ = free_space_map_.Take(tuple.GetLength());
+    if (stripe.page_id_ == INVALID_PAGE_ID) {
+      stripe.page_id_ = AppendPage();
+    }
+    page_guard = bpm_->FetchPageWrite(stripe.page_id_);
+  }
+  auto page_id = stripe.page_id_;
 
-    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
-    BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+  auto page = page_guard.AsMut<TablePage>();
+  auto slot_id = *page->InsertTuple(meta, tuple);
 
-    page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
-    BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+  // Other inserts of the stripe wait for the page latch from here on, inserts of other stripes go on.
+  guard.unlock();
 
-    page->SetNextPageId(next_page_id);
+  if (lock_mgr != nullptr) {
+    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{page_id, slot_id}),
+                  "failed to lock when inserting new tuple");
+  }
 
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+  page_guard.Drop();
 
-    page_guard.Drop();
+  return RID(page_id, slot_id);
+}
 
-    // acquire latch here as TSAN complains. Given we only have one insertion thread, this is fine.
-    npg->WLatch();
-    auto next_page_guard = WritePageGuard{bpm_, npg};
+auto TableHeap::BulkInsertTuples(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr,
+                                 Transaction *txn, table_oid_t oid) -> std::vector<RID> {
+  std::vector<RID> rids;
+  rids.reserve(tuples.size());
+  if (tuples.empty()) {
+    return rids;
+  }
 
-    last_page_id_ = next_page_id;
-    page_guard = std::move(next_page_guard);
+  // The new pages are only reachable from the table once linked, they are filled without latching them. The heap latch
+  // is held throughout, like in AppendPage(), so that they are linked after the page that is last once they are full.
+  std::unique_lock<std::mutex> guard(latch_);
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = INVALID_PAGE_ID;
+  std::vector<page_id_t> new_page_ids;
+  BasicPageGuard page_guard;
+  for (const auto &tuple : tuples) {
+    auto slot_id = page_id == INVALID_PAGE_ID ? std::nullopt : page_guard.AsMut<TablePage>()->InsertTuple(meta, tuple);
+    if (slot_id == std::nullopt) {
+      page_id_t next_page_id = INVALID_PAGE_ID;
+      auto next_page_guard = bpm_->NewPageGuarded(&next_page_id);
+      BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
+      auto next_page = next_page_guard.AsMut<TablePage>();
+      next_page->Init();
+      if (page_id == INVALID_PAGE_ID) {
+        first_page_id = next_page_id;
+      } else {
+        page_guard.AsMut<TablePage>()->SetNextPageId(next_page_id);
+      }
+      page_id = next_page_id;
+      new_page_ids.push_back(next_page_id);
+      page_guard = std::move(next_page_guard);
+      slot_id = next_page->InsertTuple(meta, tuple);
+      BUSTUB_ENSURE(slot_id != std::nullopt, "tuple is too large, cannot insert");
+    }
+    rids.emplace_back(page_id, *slot_id);
   }
-  auto last_page_id = last_page_id_;
+  auto last_free_space = page_guard.As<TablePage>()->GetFreeSpace();
+  page_guard.Drop();
 
-  auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+  // Nobody else knows the new rids yet, locking them does not wait. Other transactions can only see the tuples once
+  // they are locked.
+  if (lock_mgr != nullptr && txn != nullptr && !txn->IsTableExclusiveLocked(oid)) {
+    try {
+      for (const auto &rid : rids) {
+        BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, rid),
+                      "failed to lock when inserting new tuple");
+      }
+    } catch (...) {
+      // The tuples never became visible, the new pages are given back instead of being linked.
+      for (auto new_page_id : new_page_ids) {
+        bpm_->DeletePage(new_page_id);
+      }
+      throw;
+    }
+  }
 
-  // only allow one insertion at a time, otherwise it will deadlock.
+  auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+  last_page_guard.AsMut<TablePage>()->SetNextPageId(first_page_id);
+  last_page_id_ = page_id;
+  num_pages_ += new_page_ids.size();
+  last_page_guard.Drop();
   guard.unlock();
+  free_space_map_.Update(page_id, last_free_space);
+  return rids;
+}
 
-  if (lock_mgr != nullptr) {
-    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id}),
-                  "failed to lock when inserting new tuple");
+auto TableHeap::Vacuum(txn_id_t oldest_active_txn_id) -> VacuumStats {
+  std::scoped_lock vacuum_lock(vacuum_latch_);
+  if (!needs_vacuum_.exchange(false)) {
+    auto stats = last_vacuum_stats_;
+    stats.num_compacted_pages_ = 0;
+    stats.reclaimed_bytes_ = 0;
+    return stats;
   }
 
+  VacuumStats stats;
+  // The pages being filled by inserters go back to the free space map when the inserters are done with them.
+  std::vector<page_id_t> insert_page_ids;
+  for (auto &stripe : insert_stripes_) {
+    std::scoped_lock lock(stripe.latch_);
+    insert_page_ids.push_back(stripe.page_id_);
+  }
+  page_id_t last_page_id;
+  {
+    std::scoped_lock lock(latch_);
+    last_page_id = last_page_id_;
+  }
+
+  auto page_id = first_page_id_;
+  while (true) {
+    auto page_guard = bpm_->FetchPageRead(page_id, AccessType::Scan);
+    auto page = page_guard.As<TablePage>();
+    if (page->GetReclaimableSpace(oldest_active_txn_id) > 0) {
+      page_guard.Drop();
+      auto write_guard = bpm_->FetchPageWrite(page_id, AccessType::Scan);
+      auto reclaimed = write_guard.AsMut<TablePage>()->Compact(oldest_active_txn_id);
+      stats.num_compacted_pages_++;
+      stats.reclaimed_bytes_ += reclaimed;
+      if (std::find(insert_page_ids.begin(), insert_page_ids.end(), page_id) == insert_page_ids.end()) {
+        free_space_map_.Update(page_id, write_guard.As<TablePage>()->GetFreeSpace());
+      }
+      write_guard.Drop();
+      page_guard = bpm_->FetchPageRead(page_id, AccessType::Scan);
+      page = page_guard.As<TablePage>();
+    }
+    stats.num_pages_++;
+    stats.dead_bytes_ += page->GetDeadSpace();
+    stats.free_bytes_ += page->GetFreeSpace();
+    if (page_id == last_page_id) {
+      break;
+    }
+    page_id = page->GetNextPageId();
+  }
+  // Tuples whose deleter was still running have to be looked at again.
+  if (stats.dead_bytes_ > 0) {
+    needs_vacuum_ = true;
+  }
+  last_vacuum_stats_ = stats;
+  return stats;
+}
+
+auto TableHeap::AppendPage() -> page_id_t {
+  // The heap latch serializes appends, each page is linked after the one appended before it. Their ids need not grow
+  // along the chain, see BufferPoolManager::NewPage().
+  std::scoped_lock lock(latch_);
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto page_guard = bpm_->NewPageGuarded(&page_id);
+  BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "cannot allocate page");
+  page_guard.AsMut<TablePage>()->Init();
   page_guard.Drop();
 
-  return RID(last_page_id, slot_id);
+  auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+  last_page_guard.AsMut<TablePage>()->SetNextPageId(page_id);
+  last_page_id_ = page_id;
+  num_pages_++;
+  return page_id;
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
   page->UpdateTupleMeta(meta, rid);
+  if (meta.is_deleted_) {
+    needs_vacuum_ = true;
+  }
 }
 
-auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+auto TableHeap::GetTuple(RID rid, AccessType access_type) -> std::pair<TupleMeta, Tuple> {
+  // Copy the tuple out without latching the page first, a concurrent writer makes the copy fail validation.
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; ++attempt) {
+    auto page_guard = bpm_->FetchPageOptimistic(rid.GetPageId(), access_type);
+    try {
+      auto [meta, tuple] = page_guard.As<TablePage>()->GetTuple(rid);
+      if (page_guard.Validate()) {
+        tuple.rid_ = rid;
+        return std::make_pair(meta, std::move(tuple));
+      }
+    } catch (Exception &e) {
+      // The slot looked invalid, which is only an error if the page was not changed under the read.
+      if (page_guard.Validate()) {
+        throw;
+      }
+    }
+  }
+
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId(), access_type);
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTuples(const std::vector<RID> &rids, AccessType access_type)
+    -> std::vector<std::pair<TupleMeta, Tuple>> {
+  // Latch every page once. Sorting the page ids only groups the rids by page: the order is not the one of the chain,
+  // and any order is free of deadlocks, as writers of table pages latch one page at a time.
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(rids.size());
+  for (const auto &rid : rids) {
+    page_ids.push_back(rid.GetPageId());
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  auto pages = bpm_->FetchPages(page_ids, access_type);
+
+  std::vector<std::optional<std::pair<TupleMeta, Tuple>>> tuples(rids.size());
+  {
+    std::vector<ReadPageGuard> page_guards;
+    page_guards.reserve(pages.size());
+    for (auto page : pages) {
+      if (page != nullptr) {
+        page->RLatch();
+      }
+      page_guards.emplace_back(bpm_, page);
+    }
+    for (size_t i = 0; i < rids.size(); ++i) {
+      auto index = std::lower_bound(page_ids.begin(), page_ids.end(), rids[i].GetPageId()) - page_ids.begin();
+      if (pages[index] == nullptr) {
+        continue;
+      }
+      auto [meta, tuple] = page_guards[index].As<TablePage>()->GetTuple(rids[i]);
+      tuple.rid_ = rids[i];
+      tuples[i].emplace(meta, std::move(tuple));
+    }
+  }
+
+  // The pool could not hold all the pages at once, read the remaining tuples one at a time.
+  std::vector<std::pair<TupleMeta, Tuple>> result;
+  result.reserve(rids.size());
+  for (size_t i = 0; i < rids.size(); ++i) {
+    result.push_back(tuples[i].has_value() ? std::move(*tuples[i]) : GetTuple(rids[i], access_type));
+  }
+  return result;
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
@@ -110,7 +308,7 @@ auto TableHeap::MakeIterator() -> TableIterator {
   auto last_page_id = last_page_id_;
   guard.unlock();
 
-  auto page_guard = bpm_->FetchPageRead(last_page_id);
+  auto page_guard = bpm_->FetchPageRead(last_page_id, AccessType::Scan);
   auto page = page_guard.As<TablePage>();
   return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
 }
@@ -121,6 +319,9 @@ void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tup
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
   page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+  if (meta.is_deleted_) {
+    needs_vacuum_ = true;
+  }
 }
 
 }  // namespace bustub
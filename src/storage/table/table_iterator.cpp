@@ -21,34 +21,124 @@
 namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
+    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid), read_ahead_(table_heap->bpm_) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
+  SkipEmptyPages();
+  if (!IsEnd()) {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+    HintReadAhead(page_guard.As<TablePage>()->GetNextPageId());
   }
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+TableIterator::TableIterator(TableHeap *table_heap, page_id_t page_id, uint32_t begin_slot, uint32_t end_slot)
+    : table_heap_(table_heap),
+      rid_(begin_slot < end_slot ? RID{page_id, begin_slot} : RID{INVALID_PAGE_ID, 0}),
+      stop_at_rid_(page_id, end_slot),
+      read_ahead_(table_heap->bpm_) {}
+
+void TableIterator::SkipEmptyPages() {
+  while (rid_.GetPageId() != INVALID_PAGE_ID && !(rid_ == stop_at_rid_)) {
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+    auto page = page_guard.As<TablePage>();
+    if (rid_.GetSlotNum() < page->GetNumTuples()) {
+      return;
+    }
+    if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+      break;
+    }
+    rid_ = RID{page->GetNextPageId(), 0};
+  }
+  rid_ = RID{INVALID_PAGE_ID, 0};
+}
+
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_, AccessType::Scan); }
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
+void TableIterator::HintReadAhead(page_id_t next_page_id) {
+  // Pages after the one holding stop_at_rid_ are never scanned.
+  if (stop_at_rid_.GetPageId() == rid_.GetPageId()) {
+    next_page_id = INVALID_PAGE_ID;
+  }
+  read_ahead_.OnPage(rid_.GetPageId(), next_page_id);
+}
+
+auto TableIterator::GetEndSlot(const TablePage *page) -> uint32_t {
+  if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+    return stop_at_rid_.GetSlotNum();
+  }
+  return page->GetNumTuples();
+}
+
+void TableIterator::NextPage(const TupleFilter &filter, std::vector<Tuple> *batch, size_t max_tuples) {
+  BUSTUB_ASSERT(!IsEnd(), "iterate out of bound");
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+  auto page = page_guard.As<TablePage>();
+  auto next_page_id = page->GetNextPageId();
+  HintReadAhead(next_page_id);
+
+  auto first_slot = rid_.GetSlotNum();
+  auto end_slot = GetEndSlot(page);
+  auto slot = first_slot;
+  for (; slot < end_slot && slot - first_slot < max_tuples; ++slot) {
+    auto [meta, view] = page->GetTupleView(RID{rid_.GetPageId(), slot});
+    if (filter(meta, view)) {
+      batch->push_back(view.Materialize());
+    }
+  }
+
+  MoveTo(slot, end_slot, next_page_id);
+}
+
+auto TableIterator::SplitPage(size_t max_tuples) -> TableIterator {
+  BUSTUB_ASSERT(!IsEnd(), "iterate out of bound");
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+  auto page = page_guard.As<TablePage>();
+  auto next_page_id = page->GetNextPageId();
+  HintReadAhead(next_page_id);
+
+  auto page_id = rid_.GetPageId();
+  auto first_slot = rid_.GetSlotNum();
+  auto end_slot = GetEndSlot(page);
+  auto slot = end_slot - first_slot > max_tuples ? static_cast<uint32_t>(first_slot + max_tuples) : end_slot;
+  MoveTo(slot, end_slot, next_page_id);
+  return {table_heap_, page_id, first_slot, slot};
+}
+
+void TableIterator::MoveTo(uint32_t slot, uint32_t end_slot, page_id_t next_page_id) {
+  if (slot < end_slot) {
+    rid_ = RID{rid_.GetPageId(), slot};
+  } else if (rid_.GetPageId() == stop_at_rid_.GetPageId() || next_page_id == INVALID_PAGE_ID) {
+    rid_ = RID{INVALID_PAGE_ID, 0};
+  } else {
+    rid_ = RID{next_page_id, 0};
+  }
+}
+
+auto TableIterator::GetPageRIDs() -> std::vector<RID> {
+  BUSTUB_ASSERT(!IsEnd(), "iterate out of bound");
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+  auto page = page_guard.As<TablePage>();
+  std::vector<RID> rids;
+  for (auto slot = rid_.GetSlotNum(); slot < GetEndSlot(page); ++slot) {
+    rids.emplace_back(rid_.GetPageId(), slot);
+  }
+  return rids;
+}
+
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
   auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
+  HintReadAhead(page->GetNextPageId());
 
-  if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
-    BUSTUB_ASSERT(
-        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() < stop_at_rid_.GetPageId() ||
-            /* case 2: cursor at the page before the tuple */
-            (rid_.GetPageId() == stop_at_rid_.GetPageId() && next_tuple_id <= stop_at_rid_.GetSlotNum()),
-        "iterate out of bound");
-  }
+  // Page ids say nothing about the position of a page in the chain, as freed page ids are reused. The iterator only
+  // knows that it has not passed the stop tuple when it is on the page of that tuple.
+  BUSTUB_ASSERT(rid_.GetPageId() != stop_at_rid_.GetPageId() || next_tuple_id <= stop_at_rid_.GetSlotNum(),
+                "iterate out of bound");
 
   rid_ = RID{rid_.GetPageId(), next_tuple_id};
 
@@ -60,6 +150,8 @@ auto TableIterator::operator++() -> TableIterator & {
     auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
+    page_guard.Drop();
+    SkipEmptyPages();
   }
 
   page_guard.Drop();
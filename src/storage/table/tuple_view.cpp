@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.cpp
+//
+// Identification: src/storage/table/tuple_view.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_view.h"
+
+#include <cassert>
+
+namespace bustub {
+
+auto TupleView::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  assert(schema);
+  const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  return Value::DeserializeFrom(Tuple::GetDataPtr(data_, schema, column_idx), column_type);
+}
+
+auto TupleView::Materialize() const -> Tuple {
+  Tuple tuple(rid_);
+  tuple.data_.assign(data_, data_ + length_);
+  return tuple;
+}
+
+}  // namespace bustub
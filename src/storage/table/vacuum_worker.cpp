@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_worker.cpp
+//
+// Identification: src/storage/table/vacuum_worker.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/vacuum_worker.h"
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+VacuumWorker::VacuumWorker(Catalog *catalog, std::shared_mutex *catalog_lock, TransactionManager *txn_manager)
+    : catalog_(catalog), catalog_lock_(catalog_lock), txn_manager_(txn_manager) {}
+
+VacuumWorker::~VacuumWorker() { Stop(); }
+
+void VacuumWorker::Start(std::chrono::milliseconds interval) {
+  if (thread_.joinable()) {
+    return;
+  }
+  stop_ = false;
+  thread_ = std::thread([this, interval] {
+    std::unique_lock<std::mutex> lock(thread_latch_);
+    while (!thread_cv_.wait_for(lock, interval, [this] { return stop_; })) {
+      lock.unlock();
+      RunOnce();
+      lock.lock();
+    }
+  });
+}
+
+void VacuumWorker::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock lock(thread_latch_);
+    stop_ = true;
+  }
+  thread_cv_.notify_all();
+  thread_.join();
+}
+
+auto VacuumWorker::RunOnce() -> std::map<std::string, VacuumStats> {
+  std::vector<std::pair<std::string, TableHeap *>> tables;
+  {
+    std::shared_lock<std::shared_mutex> lock(*catalog_lock_);
+    for (const auto &table_name : catalog_->GetTableNames()) {
+      auto *table_info = catalog_->GetTable(table_name);
+      // Mock tables have no heap.
+      if (table_info->table_ != nullptr) {
+        tables.emplace_back(table_name, table_info->table_.get());
+      }
+    }
+  }
+
+  std::scoped_lock lock(latch_);
+  // Taken once for all tables: a transaction that starts during the pass only sees tuples that are not deleted yet.
+  auto oldest_active_txn_id = txn_manager_->GetOldestActiveTxnId();
+  std::map<std::string, VacuumStats> stats;
+  for (const auto &[table_name, table] : tables) {
+    auto table_stats = table->Vacuum(oldest_active_txn_id);
+    num_compacted_pages_ += table_stats.num_compacted_pages_;
+    reclaimed_bytes_ += table_stats.reclaimed_bytes_;
+    stats.emplace(table_name, table_stats);
+  }
+  num_runs_++;
+  table_stats_ = stats;
+  return stats;
+}
+
+void VacuumWorker::AppendMetrics(MetricList *metrics) {
+  std::scoped_lock lock(latch_);
+  metrics->emplace_back("vacuum.runs", num_runs_);
+  metrics->emplace_back("vacuum.compacted_pages", num_compacted_pages_);
+  metrics->emplace_back("vacuum.reclaimed_bytes", reclaimed_bytes_);
+  for (const auto &[table_name, stats] : table_stats_) {
+    auto table_bytes = stats.num_pages_ * BUSTUB_PAGE_SIZE;
+    metrics->emplace_back("vacuum." + table_name + ".pages", stats.num_pages_);
+    metrics->emplace_back("vacuum." + table_name + ".dead_bytes", stats.dead_bytes_);
+    metrics->emplace_back("vacuum." + table_name + ".free_bytes", stats.free_bytes_);
+    metrics->emplace_back("vacuum." + table_name + ".bloat_pct",
+                          table_bytes == 0 ? 0 : (stats.dead_bytes_ + stats.free_bytes_) * 100 / table_bytes);
+  }
+}
+
+}  // namespace bustub
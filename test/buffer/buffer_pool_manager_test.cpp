@@ -12,11 +12,20 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/read_ahead.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -82,6 +91,7 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
   // Shutdown the disk manager and remove the temporary file we created.
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.pagemap");
 
   delete bpm;
   delete disk_manager;
@@ -139,9 +149,796 @@ TEST(BufferPoolManagerTest, SampleTest) {
   // Shutdown the disk manager and remove the temporary file we created.
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.pagemap");
 
   delete bpm;
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ShardedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_shards = 4;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k, nullptr, num_shards);
+  EXPECT_EQ(num_shards, bpm->GetNumShards());
+
+  // Scenario: Every frame can be handed out even though frames are split unevenly across shards.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: Unpinning a page frees up a frame in its own shard only.
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], true));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(page_ids[0] % num_shards, page_id_temp % num_shards);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  for (size_t i = 1; i < page_ids.size(); ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: Concurrent fetches of pages spread over all shards see the data written before.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_shards; ++t) {
+    threads.emplace_back([&bpm, &page_ids, t] {
+      for (size_t round = 0; round < 50; ++round) {
+        auto page_id = page_ids[(t + round) % page_ids.size()];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        char expected[BUSTUB_PAGE_SIZE];
+        snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+        EXPECT_EQ(0, strcmp(page->GetData(), expected));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.pagemap");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentMissTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  // The last pages written are resident, the first ones are on disk only.
+  auto hot_page_id = page_ids.back();
+  auto cold_page_id = page_ids.front();
+  disk_manager->SetLatency(200);
+
+  // Scenario: Many threads missing on the same page share one read and all see its content.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&bpm, cold_page_id] {
+      auto *page = bpm->FetchPage(cold_page_id);
+      ASSERT_NE(nullptr, page);
+      char expected[BUSTUB_PAGE_SIZE];
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", cold_page_id);
+      EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    });
+  }
+
+  // Scenario: A hit is not blocked behind the in-flight miss.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto start = std::chrono::steady_clock::now();
+  auto *page = bpm->FetchPage(hot_page_id);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_NE(nullptr, page);
+  EXPECT_LT(elapsed, std::chrono::milliseconds(150));
+  EXPECT_EQ(true, bpm->UnpinPage(hot_page_id, false));
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < 4; ++t) {
+    EXPECT_EQ(true, bpm->UnpinPage(cold_page_id, false));
+  }
+  EXPECT_EQ(false, bpm->UnpinPage(cold_page_id, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentHitTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_pages = buffer_pool_size * 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: threads hitting and missing on more pages than the pool holds always see the page they asked for, and
+  // a page is never evicted while they hold it.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&bpm, &page_ids, t] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      for (size_t i = 0; i < 2000; ++i) {
+        auto page_id = page_ids[dist(gen)];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        char expected[BUSTUB_PAGE_SIZE];
+        snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+        page->RLatch();
+        EXPECT_EQ(page_id, page->GetPageId());
+        EXPECT_EQ(0, strcmp(page->GetData(), expected));
+        page->RUnlatch();
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every pin was released: the whole pool can be taken by new pages.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: The writer cleans the half of the pool that is next in line for eviction, and nothing else.
+  bpm->StartBackgroundWriter(0.5, std::chrono::milliseconds(5));
+  for (int i = 0; i < 200 && bpm->GetBackgroundWriteCount() < buffer_pool_size / 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetBackgroundWriteCount());
+
+  // Scenario: The next evictions find clean frames and don't write anything back.
+  for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetCleanEvictionCount());
+  EXPECT_EQ(0, bpm->GetDirtyEvictionCount());
+
+  // Scenario: The pages written by the background writer can be read back.
+  for (size_t i = 0; i < buffer_pool_size / 2; ++i) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ReplacerPolicyTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t k = 2;
+
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::ARC, ReplacerPolicy::TwoQ, ReplacerPolicy::ClockPro}) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2, policy);
+    ASSERT_EQ(policy, bpm->GetReplacerPolicy());
+
+    std::vector<page_id_t> page_ids;
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size * 4; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      page_ids.push_back(page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: Switching the policy keeps the pinned page resident, all pages can still be read back.
+    auto *pinned = bpm->FetchPage(page_ids[0]);
+    ASSERT_NE(nullptr, pinned);
+    bpm->SetReplacerPolicy(ReplacerPolicy::ClockPro);
+    for (size_t round = 0; round < 2; ++round) {
+      for (auto page_id : page_ids) {
+        auto *page = bpm->FetchPage(page_id, AccessType::Get);
+        ASSERT_NE(nullptr, page);
+        char expected[BUSTUB_PAGE_SIZE];
+        snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+        EXPECT_EQ(0, strcmp(page->GetData(), expected));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+      bpm->SetReplacerPolicy(policy);
+    }
+    EXPECT_EQ(pinned, bpm->FetchPage(page_ids[0]));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+  }
+}
+
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FrameArenaTest) {
+  const size_t buffer_pool_size = 64;
+
+  for (auto use_huge_pages : {false, true}) {
+    SCOPED_TRACE(use_huge_pages);
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), LRUK_REPLACER_K, nullptr, 4,
+                                                   ReplacerPolicy::LRUK, use_huge_pages);
+    if (!use_huge_pages) {
+      EXPECT_EQ(FrameArena::Backing::Pages, bpm->GetFrameArenaBacking());
+    }
+
+    // Scenario: the frame metadata is cache line aligned, the frame data is page aligned and contiguous.
+    auto *pages = bpm->GetPages();
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % BUSTUB_CACHELINE_SIZE);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % BUSTUB_PAGE_SIZE);
+      EXPECT_EQ(pages[0].GetData() + i * BUSTUB_PAGE_SIZE, pages[i].GetData());
+    }
+
+    // Scenario: the pool works as usual on top of the arena.
+    std::vector<page_id_t> page_ids;
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      page_ids.push_back(page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+    for (auto page_id : page_ids) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      char expected[BUSTUB_PAGE_SIZE];
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(0, strcmp(page->GetData(), expected));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+}
+
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ReadAheadTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t num_pages = buffer_pool_size * 4;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  // Reads are slow enough for the read-ahead to run ahead of the scan.
+  disk_manager->SetLatency(1);
+
+  // Scenario: pages that were never allocated are not read ahead.
+  bpm->PrefetchPages({static_cast<page_id_t>(num_pages) + 1, -1});
+
+  // Scenario: a sequential scan finds the pages read ahead in the pool, with their content.
+  ReadAhead read_ahead(bpm.get());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_pages); ++page_id) {
+    read_ahead.OnPage(page_id, page_id + 1 < static_cast<page_id_t>(num_pages) ? page_id + 1 : INVALID_PAGE_ID);
+    auto *page = bpm->FetchPage(page_id, AccessType::Scan);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  // The window grew up to a quarter of the pool.
+  EXPECT_EQ(buffer_pool_size / 4, read_ahead.GetWindow());
+  EXPECT_GT(bpm->GetHitCount(AccessType::Scan), 0);
+  EXPECT_GT(bpm->GetPrefetchCount(), 0);
+
+  // Scenario: a link that breaks the sequence resets the window.
+  read_ahead.OnPage(3, 10);
+  EXPECT_EQ(0, read_ahead.GetWindow());
+
+  // Scenario: a page read ahead and never fetched can still be deleted.
+  bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get());
+  for (size_t i = 0; i < 8; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  bpm->PrefetchPages({0});
+  for (size_t i = 0; i < 1000 && bpm->GetPrefetchCount() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1, bpm->GetPrefetchCount());
+  EXPECT_EQ(true, bpm->DeletePage(0));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DeletePageTest) {
+  const size_t buffer_pool_size = 8;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(buffer_pool_size * 2, disk_manager->GetNumPages());
+
+  // Scenario: a pinned page cannot be deleted.
+  ASSERT_NE(nullptr, bpm->FetchPage(3));
+  EXPECT_EQ(false, bpm->DeletePage(3));
+  EXPECT_EQ(true, bpm->UnpinPage(3, false));
+
+  // Scenario: resident and evicted pages are both given back to the disk manager.
+  EXPECT_EQ(true, bpm->DeletePage(3));
+  EXPECT_EQ(true, bpm->DeletePage(4));
+  EXPECT_EQ(true, bpm->DeletePage(15));
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  EXPECT_EQ(3, disk_manager->GetNumFreePages());
+  EXPECT_EQ(buffer_pool_size * 2 - 1, disk_manager->GetNumPages());
+
+  // Scenario: a reader that still has the id of a deleted page does not load it back into the pool.
+  EXPECT_EQ(nullptr, bpm->FetchPage(3));
+  EXPECT_EQ(nullptr, bpm->FetchPages({4, 5})[0]);
+  EXPECT_EQ(true, bpm->UnpinPage(5, false));
+
+  // Scenario: new pages reuse the freed ids of their shard, lowest first, before the file grows.
+  for (page_id_t expected : {0, 3, 4, 15}) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(expected, page_id_temp);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+
+  // Scenario: a reused id maps to the one frame of the new page, which keeps its writes through evictions.
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(static_cast<page_id_t>(i)));
+    EXPECT_EQ(true, bpm->UnpinPage(static_cast<page_id_t>(i), false));
+  }
+  for (page_id_t page_id : {0, 3, 4, 15}) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(buffer_pool_size * 2, disk_manager->GetNumPages());
+}
+
+/** Fails every read and write of one page. */
+class FailingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == failing_page_id_) {
+      throw Exception("injected read error");
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    if (page_id == failing_page_id_) {
+      throw Exception("injected write error");
+    }
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  std::atomic<page_id_t> failing_page_id_{INVALID_PAGE_ID};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, IOFailureTest) {
+  const size_t buffer_pool_size = 4;
+
+  auto disk_manager = std::make_unique<FailingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: a page that cannot be read is not fetched, and its frame is not lost to the pool.
+  disk_manager->failing_page_id_ = 2;
+  EXPECT_EQ(nullptr, bpm->FetchPage(2));
+  EXPECT_EQ(nullptr, bpm->FetchPages({2})[0]);
+  for (page_id_t page_id : {0, 1, 3, 4}) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+  }
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->UnpinPage(3, false));
+
+  // Scenario: a page that cannot be written stays dirty.
+  disk_manager->failing_page_id_ = 4;
+  auto *page = bpm->FetchPage(4);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page 4 updated");
+  EXPECT_EQ(true, bpm->UnpinPage(4, true));
+  EXPECT_EQ(false, bpm->FlushPage(4));
+  EXPECT_EQ(true, page->IsDirty());
+  EXPECT_EQ(true, bpm->UnpinPage(4, false));
+
+  // Scenario: a dirty victim that cannot be written keeps its frame, and its changes are not lost.
+  for (page_id_t page_id : {0, 1, 3}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(5));
+  disk_manager->failing_page_id_ = INVALID_PAGE_ID;
+  page = bpm->FetchPage(5);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "page 5"));
+  EXPECT_EQ(true, bpm->UnpinPage(5, false));
+  for (page_id_t page_id : {0, 1, 3}) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  page = bpm->FetchPage(4);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "page 4 updated"));
+  EXPECT_EQ(true, bpm->UnpinPage(4, false));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, WarmUpTest) {
+  const size_t buffer_pool_size = 16;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  // Pages 16 to 31 are resident, 20 to 27 are accessed again and become the hottest.
+  for (page_id_t page_id = 20; page_id < 28; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: all the resident pages are saved.
+  EXPECT_EQ(buffer_pool_size, bpm->DumpResidentPages("test.warmup"));
+  bpm->FlushAllPages();
+
+  // Scenario: a smaller pool after a restart warms up with the hottest pages.
+  bpm = std::make_unique<BufferPoolManager>(buffer_pool_size / 2, disk_manager.get());
+  EXPECT_EQ(0, bpm->StartWarmUp("missing.warmup"));
+  EXPECT_EQ(buffer_pool_size / 2, bpm->StartWarmUp("test.warmup"));
+  bpm->WaitForWarmUp();
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetWarmUpPageCount());
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetWarmedUpPageCount());
+  for (page_id_t page_id = 20; page_id < 28; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetMissCount(AccessType::Unknown));
+
+  // Scenario: pages deallocated since the pages were saved are not read.
+  bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  EXPECT_EQ(true, bpm->DeletePage(31));
+  EXPECT_EQ(buffer_pool_size - 1, bpm->StartWarmUp("test.warmup"));
+  bpm->WaitForWarmUp();
+  for (page_id_t page_id = 16; page_id < 31; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetMissCount(AccessType::Unknown));
+
+  remove("test.warmup");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t max_pool_size = 32;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2,
+                                                 ReplacerPolicy::LRUK, false, max_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+  EXPECT_THROW(bpm->Resize(max_pool_size + 1), std::logic_error);
+  EXPECT_THROW(bpm->Resize(1), std::logic_error);
+
+  // Scenario: once grown, the pool holds as many pinned pages as its new size.
+  bpm->Resize(max_pool_size);
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < max_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: shrinking waits for the pinned pages, and writes the dirty ones back.
+  for (size_t i = 0; i < max_pool_size; i += 2) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+  std::thread resizer([&bpm, buffer_pool_size] { bpm->Resize(buffer_pool_size); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (size_t i = 1; i < max_pool_size; i += 2) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+  resizer.join();
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+
+  // Scenario: the shrunk pool only holds as many pinned pages as its new size, and every page survived.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[buffer_pool_size]));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: frames given back can be used again after growing.
+  bpm->Resize(max_pool_size);
+  for (auto page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+
+  // Scenario: shrinking gives up on frames that stay pinned, and the pool keeps them.
+  EXPECT_THROW(bpm->Resize(buffer_pool_size, std::chrono::milliseconds(10)), Exception);
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  bpm->Resize(buffer_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, MetricsTest) {
+  const size_t buffer_pool_size = 4;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t page_id = 0; page_id < 2; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Get));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Get));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: the counters of the pool and the latencies of its I/O are reported by name.
+  auto metrics = bpm->GetMetrics();
+  auto metric = [&metrics](const std::string &name) -> uint64_t {
+    for (const auto &[metric_name, value] : metrics) {
+      if (metric_name == name) {
+        return value;
+      }
+    }
+    ADD_FAILURE() << "missing metric " << name;
+    return 0;
+  };
+  EXPECT_EQ(buffer_pool_size, metric("bpm.pool_size"));
+  EXPECT_EQ(buffer_pool_size, metric("bpm.resident_pages"));
+  EXPECT_EQ(2, metric("bpm.hits.get"));
+  EXPECT_EQ(2, metric("bpm.misses.get"));
+  EXPECT_EQ(50, metric("bpm.hit_ratio_pct"));
+  EXPECT_EQ(6, metric("bpm.evictions.clean") + metric("bpm.evictions.dirty"));
+  EXPECT_EQ(2, metric("bpm.miss.count"));
+  EXPECT_EQ(2, metric("disk.read.count"));
+  EXPECT_LE(1, metric("disk.write.count"));
+  EXPECT_EQ(bpm->GetMissLatency().Count(), metric("bpm.miss.count"));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FetchPagesTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_pages = buffer_pool_size * 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto expect_page = [](Page *page, page_id_t page_id) {
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(page_id, page->GetPageId());
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+  };
+
+  // Scenario: hits and misses come back in the order asked for, a duplicate pins its page twice.
+  auto hits = bpm->GetHitCount(AccessType::Get);
+  auto misses = bpm->GetMissCount(AccessType::Get);
+  auto pages = bpm->FetchPages({0, 1, 15, 1, INVALID_PAGE_ID}, AccessType::Get);
+  ASSERT_EQ(5, pages.size());
+  expect_page(pages[0], 0);
+  expect_page(pages[1], 1);
+  expect_page(pages[2], 15);
+  EXPECT_EQ(pages[1], pages[3]);
+  EXPECT_EQ(nullptr, pages[4]);
+  EXPECT_EQ(hits + 2, bpm->GetHitCount(AccessType::Get));
+  EXPECT_EQ(misses + 2, bpm->GetMissCount(AccessType::Get));
+  EXPECT_EQ(2, bpm->GetMissLatency().Count());
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(false, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->UnpinPage(15, false));
+
+  // Scenario: more pages of a shard than it has frames, the pages that do not fit are not fetched.
+  pages = bpm->FetchPages({0, 2, 4, 6, 8});
+  EXPECT_EQ(1, std::count(pages.begin(), pages.end(), nullptr));
+  for (auto *page : pages) {
+    if (page != nullptr) {
+      expect_page(page, page->GetPageId());
+      EXPECT_EQ(true, bpm->UnpinPage(page->GetPageId(), false));
+    }
+  }
+
+  // Scenario: guards latch the pages and unpin them when dropped.
+  {
+    auto guards = bpm->FetchPagesRead({3, 5, 7});
+    ASSERT_EQ(3, guards.size());
+    for (size_t i = 0; i < guards.size(); ++i) {
+      char expected[BUSTUB_PAGE_SIZE];
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %zu", 3 + 2 * i);
+      EXPECT_EQ(0, strcmp(guards[i].GetData(), expected));
+    }
+  }
+  {
+    auto guards = bpm->FetchPagesWrite({3, 5});
+    snprintf(guards[0].AsMut<char>(), BUSTUB_PAGE_SIZE, "updated");
+  }
+  EXPECT_EQ(false, bpm->UnpinPage(3, false));
+  EXPECT_EQ(false, bpm->UnpinPage(5, false));
+  EXPECT_EQ(0, strcmp(bpm->FetchPageBasic(3).GetData(), "updated"));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, CompressedCacheTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = buffer_pool_size * 4;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 1,
+                                                 ReplacerPolicy::LRUK, true, 0, num_pages * BUSTUB_PAGE_SIZE);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto metric = [&bpm](const std::string &name) -> uint64_t {
+    for (const auto &[metric_name, value] : bpm->GetMetrics()) {
+      if (metric_name == name) {
+        return value;
+      }
+    }
+    ADD_FAILURE() << "missing metric " << name;
+    return 0;
+  };
+
+  // Scenario: evicted pages, dirty or not, are served from the compressed cache without touching the disk.
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_pages); ++page_id) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      char expected[BUSTUB_PAGE_SIZE];
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(0, strcmp(page->GetData(), expected));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+  EXPECT_EQ(0, metric("disk.read.count"));
+  EXPECT_EQ(0, metric("disk.write.count"));
+  EXPECT_EQ(num_pages * 2, metric("tier.hits"));
+  EXPECT_EQ(num_pages - buffer_pool_size, metric("tier.pages"));
+  EXPECT_GT(metric("tier.compression_ratio_pct"), 1000);
+
+  // Scenario: batch fetches use the cache too, and deleted pages leave it.
+  auto pages = bpm->FetchPages({0, 1});
+  ASSERT_NE(nullptr, pages[0]);
+  EXPECT_EQ(0, strcmp(pages[1]->GetData(), "page 1"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->DeletePage(2));
+  EXPECT_EQ(num_pages - buffer_pool_size - 1, metric("tier.pages"));
+
+  // Scenario: flushing writes the dirty pages of the pool and of the cache, a pool without a cache reads them back.
+  bpm->FlushAllPages();
+  bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_pages); ++page_id) {
+    if (page_id == 2) {
+      continue;
+    }
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    char expected[BUSTUB_PAGE_SIZE];
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+}
+
 }  // namespace bustub
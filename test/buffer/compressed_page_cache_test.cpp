@@ -0,0 +1,217 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/page_compressor.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** A page of small integers, like a table page of an integer column. */
+static void FillIntegerPage(char *page, int32_t seed) {
+  memset(page, 0, BUSTUB_PAGE_SIZE);
+  for (size_t i = 0; i < BUSTUB_PAGE_SIZE / sizeof(int32_t) / 2; ++i) {
+    auto value = static_cast<int32_t>(seed + i % 100);
+    memcpy(page + i * sizeof(int32_t), &value, sizeof(value));
+  }
+}
+
+/** Holds the writes until Release() is called. WaitForWrite() returns once the first one has started. */
+class BlockingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    if (num_writes_++ == 0) {
+      write_started_.set_value();
+    }
+    released_.wait();
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data) override {
+    for (size_t i = 0; i < pages_data.size(); i++) {
+      WritePage(first_page_id + static_cast<page_id_t>(i), pages_data[i]);
+    }
+  }
+
+  void WaitForWrite() { write_started_.get_future().wait(); }
+
+  void Release() { release_.set_value(); }
+
+ private:
+  std::atomic<int> num_writes_{0};
+  std::promise<void> write_started_;
+  std::promise<void> release_;
+  std::shared_future<void> released_{release_.get_future()};
+};
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, PageCompressorTest) {
+  char page[BUSTUB_PAGE_SIZE];
+  char compressed[BUSTUB_PAGE_SIZE];
+  char decompressed[BUSTUB_PAGE_SIZE];
+
+  // Scenario: an empty page compresses to a few bytes.
+  memset(page, 0, BUSTUB_PAGE_SIZE);
+  auto size = PageCompressor::Compress(page, compressed, BUSTUB_PAGE_SIZE);
+  EXPECT_GT(size, 0);
+  EXPECT_LT(size, 32);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, size, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: integer-heavy pages compress several times.
+  FillIntegerPage(page, 42);
+  size = PageCompressor::Compress(page, compressed, BUSTUB_PAGE_SIZE);
+  EXPECT_GT(size, 0);
+  EXPECT_LT(size, BUSTUB_PAGE_SIZE / 3);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, size, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: random data does not fit in less than a page, but round trips given enough room.
+  std::mt19937 generator(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(generator());
+  }
+  EXPECT_EQ(0, PageCompressor::Compress(page, compressed, BUSTUB_PAGE_SIZE));
+  char large[BUSTUB_PAGE_SIZE * 2];
+  size = PageCompressor::Compress(page, large, sizeof(large));
+  ASSERT_GT(size, 0);
+  ASSERT_TRUE(PageCompressor::Decompress(large, size, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: truncated input is rejected.
+  EXPECT_FALSE(PageCompressor::Decompress(large, size / 2, decompressed));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(disk_manager.get());
+  char page[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE];
+  bool is_dirty;
+
+  // The cache holds three integer pages, whose compressed sizes differ by a few bytes.
+  FillIntegerPage(page, 0);
+  auto page_size = PageCompressor::Compress(page, data, BUSTUB_PAGE_SIZE);
+  CompressedPageCache cache(page_size * 7 / 2, disk_scheduler.get());
+
+  // Scenario: a page is handed back once, with its dirty flag.
+  for (page_id_t page_id = 0; page_id < 3; ++page_id) {
+    FillIntegerPage(page, page_id);
+    EXPECT_TRUE(cache.Put(page_id, page, page_id == 0));
+  }
+  ASSERT_TRUE(cache.Get(1, data, &is_dirty));
+  EXPECT_FALSE(is_dirty);
+  FillIntegerPage(page, 1);
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+  EXPECT_FALSE(cache.Get(1, data, &is_dirty));
+
+  // Scenario: pages are evicted in the order they were cached, dirty ones are written to disk first.
+  for (page_id_t page_id = 3; page_id < 5; ++page_id) {
+    FillIntegerPage(page, page_id);
+    EXPECT_TRUE(cache.Put(page_id, page, true));
+  }
+  EXPECT_FALSE(cache.Get(0, data, &is_dirty));
+  disk_manager->ReadPage(0, data);
+  FillIntegerPage(page, 0);
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+
+  // Scenario: flushing writes the dirty pages that are still cached, which stay cached as clean pages.
+  EXPECT_EQ(2, cache.Flush());
+  EXPECT_EQ(0, cache.Flush());
+  disk_manager->ReadPage(4, data);
+  FillIntegerPage(page, 4);
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+  ASSERT_TRUE(cache.Get(4, data, &is_dirty));
+  EXPECT_FALSE(is_dirty);
+
+  // Scenario: incompressible pages are not cached, erased pages are gone.
+  std::mt19937 generator(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(generator());
+  }
+  EXPECT_FALSE(cache.Put(5, page, true));
+  cache.Erase(3);
+  EXPECT_FALSE(cache.Get(3, data, &is_dirty));
+
+  MetricList metrics;
+  cache.AppendMetrics(&metrics);
+  for (const auto &[name, value] : metrics) {
+    if (name == "tier.hits") {
+      EXPECT_EQ(2, value);
+    } else if (name == "tier.rejected") {
+      EXPECT_EQ(1, value);
+    } else if (name == "tier.pages") {
+      EXPECT_EQ(1, value);
+    } else if (name == "tier.compression_ratio_pct") {
+      EXPECT_GT(value, 300);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, WriteBackTest) {
+  auto disk_manager = std::make_unique<BlockingDiskManager>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(disk_manager.get());
+  char page[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE];
+  bool is_dirty;
+
+  FillIntegerPage(page, 0);
+  auto page_size = PageCompressor::Compress(page, data, BUSTUB_PAGE_SIZE);
+  CompressedPageCache cache(page_size * 5 / 2, disk_scheduler.get());
+  for (page_id_t page_id = 0; page_id < 2; ++page_id) {
+    FillIntegerPage(page, page_id);
+    EXPECT_TRUE(cache.Put(page_id, page, page_id == 0));
+  }
+
+  // The third page evicts the first one, which is dirty, and the write of it hangs.
+  std::thread putter([&] {
+    char new_page[BUSTUB_PAGE_SIZE];
+    FillIntegerPage(new_page, 2);
+    EXPECT_TRUE(cache.Put(2, new_page, false));
+  });
+  disk_manager->WaitForWrite();
+
+  // Scenario: the other pages are still handed out while the evicted page is written.
+  ASSERT_TRUE(cache.Get(1, data, &is_dirty));
+  FillIntegerPage(page, 1);
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+
+  // Scenario: a reader of the evicted page waits for the write, and then finds the page on disk.
+  auto getter = std::async(std::launch::async, [&] {
+    char evicted[BUSTUB_PAGE_SIZE];
+    bool evicted_dirty;
+    return cache.Get(0, evicted, &evicted_dirty);
+  });
+  EXPECT_EQ(std::future_status::timeout, getter.wait_for(std::chrono::milliseconds(50)));
+  disk_manager->Release();
+  EXPECT_FALSE(getter.get());
+  putter.join();
+  disk_manager->ReadPage(0, data);
+  FillIntegerPage(page, 0);
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+}
+
+}  // namespace bustub
@@ -0,0 +1,180 @@
+/**
+ * frame_replacer_test.cpp
+ */
+
+#include "buffer/frame_replacer.h"
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_pro_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Load page_id into the frame and unpin it, the way the buffer pool does on a miss. */
+static void LoadPage(FrameReplacer *replacer, frame_id_t frame_id, page_id_t page_id,
+                     AccessType access_type = AccessType::Get) {
+  replacer->RecordLoad(frame_id, page_id);
+  replacer->RecordAccess(frame_id, access_type);
+  replacer->SetEvictable(frame_id, true);
+}
+
+static auto EvictOne(FrameReplacer *replacer) -> frame_id_t {
+  frame_id_t frame_id = -1;
+  EXPECT_TRUE(replacer->Evict(&frame_id));
+  return frame_id;
+}
+
+TEST(FrameReplacerTest, PolicyNameTest) {
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::ARC, ReplacerPolicy::TwoQ, ReplacerPolicy::ClockPro}) {
+    EXPECT_EQ(policy, ReplacerPolicyFromString(ReplacerPolicyToString(policy)));
+  }
+  EXPECT_EQ(ReplacerPolicy::ClockPro, ReplacerPolicyFromString("CLOCK_PRO"));
+  EXPECT_THROW(ReplacerPolicyFromString("mru"), Exception);
+}
+
+// Every policy honours the evictable flags and tracks each frame until it is evicted or removed.
+TEST(FrameReplacerTest, EvictableTest) {
+  const size_t num_frames = 16;
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::ARC, ReplacerPolicy::TwoQ, ReplacerPolicy::ClockPro}) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto replacer = MakeReplacer(policy, num_frames, 2);
+    frame_id_t frame_id;
+
+    for (frame_id_t fid = 0; fid < static_cast<frame_id_t>(num_frames); fid++) {
+      replacer->RecordLoad(fid, fid);
+      replacer->RecordAccess(fid, AccessType::Get);
+    }
+    ASSERT_EQ(0, replacer->Size());
+    ASSERT_FALSE(replacer->Evict(&frame_id));
+
+    for (frame_id_t fid = 0; fid < static_cast<frame_id_t>(num_frames); fid++) {
+      replacer->RecordAccess(fid % 3 == 0 ? fid : 0, AccessType::Get);
+      replacer->SetEvictable(fid, true);
+    }
+    ASSERT_EQ(num_frames, replacer->Size());
+
+    // Scenario: a pinned frame can neither be evicted nor removed.
+    replacer->SetEvictable(5, false);
+    ASSERT_EQ(num_frames - 1, replacer->Size());
+    EXPECT_THROW(replacer->Remove(5), std::logic_error);
+
+    // Scenario: a removed frame is gone, removing it again does nothing.
+    replacer->SetEvictable(7, true);
+    replacer->Remove(7);
+    replacer->Remove(7);
+    ASSERT_EQ(num_frames - 2, replacer->Size());
+
+    // Scenario: the candidates are exactly the evictable frames, and listing them changes nothing.
+    auto candidates = replacer->EvictionCandidates(num_frames);
+    ASSERT_EQ(num_frames - 2, candidates.size());
+    ASSERT_EQ(num_frames - 2, std::set<frame_id_t>(candidates.begin(), candidates.end()).size());
+    EXPECT_EQ(candidates.end(), std::find(candidates.begin(), candidates.end(), 5));
+    EXPECT_EQ(candidates.end(), std::find(candidates.begin(), candidates.end(), 7));
+    ASSERT_EQ(num_frames - 2, replacer->Size());
+
+    // Scenario: every evictable frame is evicted exactly once.
+    std::set<frame_id_t> evicted;
+    while (replacer->Evict(&frame_id)) {
+      EXPECT_TRUE(evicted.insert(frame_id).second);
+    }
+    EXPECT_EQ(num_frames - 2, evicted.size());
+    EXPECT_EQ(0, evicted.count(5));
+    EXPECT_EQ(0, evicted.count(7));
+    ASSERT_EQ(0, replacer->Size());
+
+    // Scenario: an evicted frame is tracked again from its next access.
+    replacer->SetEvictable(3, true);
+    ASSERT_EQ(0, replacer->Size());
+    LoadPage(replacer.get(), 3, 100);
+    replacer->SetEvictable(5, true);
+    ASSERT_EQ(2, replacer->Size());
+  }
+}
+
+TEST(FrameReplacerTest, ArcTest) {
+  ArcReplacer replacer(4);
+  for (frame_id_t fid = 0; fid < 4; fid++) {
+    LoadPage(&replacer, fid, fid);
+  }
+  // Frame 1 is accessed twice and moves to T2.
+  replacer.RecordAccess(1, AccessType::Get);
+
+  // Scenario: T1 has no room to spare, its LRU frame goes first and page 0 is remembered in B1.
+  ASSERT_EQ(0, EvictOne(&replacer));
+
+  // Scenario: page 0 comes back while in B1, so it goes to T2 and T1's target grows to one frame.
+  LoadPage(&replacer, 0, 0);
+  ASSERT_EQ(2, EvictOne(&replacer));
+  // T1 is down to its target, T2 gives up its LRU frame now.
+  ASSERT_EQ(1, EvictOne(&replacer));
+
+  // Scenario: scans do not promote a frame to T2, so T1 stays above its target and gives up frame 3 first.
+  LoadPage(&replacer, 1, 10, AccessType::Scan);
+  replacer.RecordAccess(1, AccessType::Scan);
+  ASSERT_EQ(3, EvictOne(&replacer));
+  ASSERT_EQ(0, EvictOne(&replacer));
+  ASSERT_EQ(1, EvictOne(&replacer));
+}
+
+TEST(FrameReplacerTest, TwoQueueTest) {
+  TwoQueueReplacer replacer(8);
+  for (frame_id_t fid = 0; fid < 4; fid++) {
+    LoadPage(&replacer, fid, fid);
+  }
+  // An access right after the load is correlated with it and does not protect the frame.
+  replacer.RecordAccess(0, AccessType::Get);
+
+  // Scenario: A1in is above its share of two frames, so its oldest frame goes first and page 0 moves to A1out.
+  ASSERT_EQ(0, EvictOne(&replacer));
+
+  // Scenario: page 0 comes back while in A1out and joins Am, which is only evicted from once A1in is small enough.
+  LoadPage(&replacer, 0, 0);
+  ASSERT_EQ(1, EvictOne(&replacer));
+  ASSERT_EQ(0, EvictOne(&replacer));
+  ASSERT_EQ(2, EvictOne(&replacer));
+
+  // Scenario: page 1 was in A1out as well and joins Am, page 0 was forgotten when it left Am and starts over.
+  LoadPage(&replacer, 1, 1);
+  LoadPage(&replacer, 0, 0);
+  LoadPage(&replacer, 4, 4);
+  ASSERT_EQ(3, EvictOne(&replacer));
+  ASSERT_EQ(1, EvictOne(&replacer));
+  ASSERT_EQ(0, EvictOne(&replacer));
+  ASSERT_EQ(4, EvictOne(&replacer));
+}
+
+TEST(FrameReplacerTest, ClockProTest) {
+  ClockProReplacer replacer(4);
+  // The first three pages fill the hot set, the fourth is cold and in its test period.
+  for (frame_id_t fid = 0; fid < 4; fid++) {
+    LoadPage(&replacer, fid, fid);
+  }
+
+  // Scenario: only the cold frame is evicted, over and over, while a scan streams through the pool.
+  ASSERT_EQ(3, EvictOne(&replacer));
+  for (page_id_t page_id = 10; page_id < 20; page_id++) {
+    LoadPage(&replacer, 3, page_id, AccessType::Scan);
+    ASSERT_EQ(3, EvictOne(&replacer));
+  }
+
+  // Scenario: page 3 comes back within its test period and turns hot, at the expense of the hot frames that were
+  // not accessed since.
+  LoadPage(&replacer, 3, 3);
+  replacer.RecordAccess(2, AccessType::Get);
+  auto first = EvictOne(&replacer);
+  auto second = EvictOne(&replacer);
+  EXPECT_NE(3, first);
+  EXPECT_NE(3, second);
+  EXPECT_NE(2, first);
+  EXPECT_NE(2, second);
+}
+
+}  // namespace bustub
@@ -95,4 +95,92 @@ TEST(LRUKReplacerTest, SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  LRUKReplacer lru_replacer(8, 2);
+
+  // Scenario: frames 1 and 2 form the working set, each of them accessed twice.
+  for (frame_id_t fid : {1, 2}) {
+    lru_replacer.RecordAccess(fid, AccessType::Get);
+    lru_replacer.RecordAccess(fid, AccessType::Get);
+    lru_replacer.SetEvictable(fid, true);
+  }
+  // A scan passes over frames 3 to 6, and also touches frame 1 on its way.
+  for (frame_id_t fid : {3, 4, 5, 6}) {
+    lru_replacer.RecordAccess(fid, AccessType::Scan);
+    lru_replacer.SetEvictable(fid, true);
+  }
+  lru_replacer.RecordAccess(1, AccessType::Scan);
+  // A second scan over frame 3 does not make it part of the working set.
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  ASSERT_EQ(6, lru_replacer.Size());
+
+  // Scenario: the scanned frames go first, in LRU order, then the working set by k-distance.
+  int value;
+  for (frame_id_t expected : {4, 5, 6, 3, 1, 2}) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+  ASSERT_EQ(0, lru_replacer.Size());
+
+  // Scenario: a scanned frame that is then read like any other page leaves the probationary group.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(3, AccessType::Get);
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+  for (frame_id_t fid : {1, 3, 4}) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+  for (frame_id_t expected : {4, 1, 3}) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+}
+
+TEST(LRUKReplacerTest, RemoveTest) {
+  LRUKReplacer lru_replacer(8, 3);
+
+  for (frame_id_t fid = 0; fid < 8; fid++) {
+    lru_replacer.RecordAccess(fid);
+    lru_replacer.SetEvictable(fid, true);
+  }
+  for (frame_id_t fid : {2, 2, 5, 5, 5}) {
+    lru_replacer.RecordAccess(fid);
+  }
+  ASSERT_EQ(8, lru_replacer.Size());
+
+  // Removing an evictable frame drops it from the eviction order, a frame that is not tracked is ignored.
+  lru_replacer.Remove(3);
+  lru_replacer.Remove(3);
+  ASSERT_EQ(7, lru_replacer.Size());
+
+  // Removing a frame that is still in use is an error.
+  lru_replacer.SetEvictable(4, false);
+  EXPECT_THROW(lru_replacer.Remove(4), std::logic_error);
+  ASSERT_EQ(6, lru_replacer.Size());
+
+  // The candidates come in eviction order and leave the replacer untouched.
+  std::vector<frame_id_t> expected{0, 1, 6, 7, 2, 5};
+  EXPECT_EQ(std::vector<frame_id_t>(expected.begin(), expected.begin() + 3), lru_replacer.EvictionCandidates(3));
+  EXPECT_EQ(expected, lru_replacer.EvictionCandidates(16));
+  ASSERT_EQ(6, lru_replacer.Size());
+
+  int value;
+  for (auto fid : expected) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    EXPECT_EQ(fid, value);
+  }
+  ASSERT_FALSE(lru_replacer.Evict(&value));
+
+  // A removed frame starts over with an empty history.
+  lru_replacer.RecordAccess(5);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.SetEvictable(5, true);
+  lru_replacer.SetEvictable(1, true);
+  lru_replacer.Remove(5);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+}
+
 }  // namespace bustub
@@ -0,0 +1,123 @@
+/**
+ * page_table_test.cpp
+ */
+
+#include "buffer/page_table.h"
+
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  frame_id_t frame_id;
+
+  // Scenario: pages are found in the frames they were inserted with, absent pages are not found.
+  page_table.Insert(0, 3);
+  page_table.Insert(8, 1);
+  page_table.Insert(16, 0);
+  ASSERT_EQ(3, page_table.Size());
+  ASSERT_TRUE(page_table.Find(8, &frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_FALSE(page_table.Find(4, &frame_id));
+
+  // Scenario: erasing a page keeps the others reachable, erasing it again does nothing.
+  ASSERT_TRUE(page_table.Erase(0));
+  ASSERT_FALSE(page_table.Erase(0));
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+  ASSERT_TRUE(page_table.Find(16, &frame_id));
+  EXPECT_EQ(0, frame_id);
+  page_table.Insert(24, 3);
+  ASSERT_EQ(3, page_table.Size());
+
+  size_t count = 0;
+  page_table.ForEach([&count](page_id_t page_id, frame_id_t frame_id) { count++; });
+  EXPECT_EQ(3, count);
+}
+
+// The table agrees with a std::unordered_map through a long series of inserts and erases, which makes the clusters
+// wrap around the end of the table and exercises every case of the backward shift.
+TEST(PageTableTest, RandomTest) {
+  const size_t max_entries = 64;
+  PageTable page_table(max_entries);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 255);
+
+  for (size_t i = 0; i < 20000; i++) {
+    auto page_id = page_dist(gen);
+    if (expected.count(page_id) != 0) {
+      ASSERT_TRUE(page_table.Erase(page_id));
+      expected.erase(page_id);
+    } else if (expected.size() < max_entries) {
+      auto frame_id = static_cast<frame_id_t>(i % max_entries);
+      page_table.Insert(page_id, frame_id);
+      expected[page_id] = frame_id;
+    }
+    ASSERT_EQ(expected.size(), page_table.Size());
+  }
+  for (page_id_t page_id = 0; page_id < 256; page_id++) {
+    frame_id_t frame_id;
+    ASSERT_EQ(expected.count(page_id) != 0, page_table.Find(page_id, &frame_id));
+    if (expected.count(page_id) != 0) {
+      EXPECT_EQ(expected[page_id], frame_id);
+    }
+  }
+}
+
+// Lock-free readers only ever see mappings that were inserted, while a writer keeps inserting and erasing around them.
+TEST(PageTableTest, ConcurrentReadTest) {
+  const size_t max_entries = 32;
+  PageTable page_table(max_entries);
+  // Page p is always mapped to frame p % max_entries, pages below max_entries are never erased.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries / 2); page_id++) {
+    page_table.Insert(page_id, page_id % max_entries);
+  }
+
+  std::atomic<bool> stop = false;
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t < 2; t++) {
+    readers.emplace_back([&page_table, &stop, max_entries] {
+      while (!stop) {
+        for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries * 4); page_id++) {
+          frame_id_t frame_id;
+          if (page_table.Find(page_id, &frame_id)) {
+            ASSERT_EQ(page_id % static_cast<page_id_t>(max_entries), frame_id);
+          }
+        }
+      }
+    });
+  }
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> page_dist(max_entries, max_entries * 4 - 1);
+  std::vector<page_id_t> inserted;
+  for (size_t i = 0; i < 20000; i++) {
+    if (inserted.size() == max_entries / 2) {
+      page_table.Erase(inserted.front());
+      inserted.erase(inserted.begin());
+    }
+    auto page_id = page_dist(gen);
+    frame_id_t frame_id;
+    if (!page_table.Find(page_id, &frame_id)) {
+      page_table.Insert(page_id, page_id % max_entries);
+      inserted.push_back(page_id);
+    }
+  }
+  stop = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(max_entries / 2); page_id++) {
+    frame_id_t frame_id;
+    ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+  }
+}
+
+}  // namespace bustub
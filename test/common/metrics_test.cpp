@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics_test.cpp
+//
+// Identification: test/common/metrics_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/metrics.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MetricsTest, StripedCounterTest) {
+  StripedCounter counter;
+  EXPECT_EQ(0, counter.Get());
+
+  // Scenario: increments of all threads are counted once they are done.
+  const size_t num_threads = METRIC_STRIPES * 2;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&counter] {
+      for (size_t j = 0; j < 1000; ++j) {
+        counter.Add();
+      }
+      counter.Add(5);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * 1005, counter.Get());
+}
+
+// NOLINTNEXTLINE
+TEST(MetricsTest, LatencyHistogramTest) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Count());
+  EXPECT_EQ(0, histogram.Percentile(50));
+
+  // Scenario: durations land in power of two buckets, percentiles report the upper end of their bucket.
+  for (size_t i = 0; i < 98; ++i) {
+    histogram.Record(std::chrono::nanoseconds(1000));
+  }
+  histogram.Record(std::chrono::microseconds(100));
+  histogram.Record(std::chrono::seconds(1));
+  EXPECT_EQ(100, histogram.Count());
+  EXPECT_EQ(98 * 1000 + 100000 + 1000000000, histogram.Sum());
+  EXPECT_EQ(1024, histogram.Percentile(50));
+  EXPECT_EQ(1024, histogram.Percentile(98));
+  EXPECT_EQ(131072, histogram.Percentile(99));
+  EXPECT_EQ(1073741824, histogram.Percentile(100));
+
+  // Scenario: negative durations count as zero, huge ones go to the last bucket.
+  histogram.Record(std::chrono::nanoseconds(-5));
+  histogram.Record(std::chrono::hours(24));
+  EXPECT_EQ(102, histogram.Count());
+  EXPECT_EQ(1, histogram.Percentile(0.5));
+  EXPECT_EQ(uint64_t{1} << (LatencyHistogram::NUM_BUCKETS - 1), histogram.Percentile(100));
+
+  MetricList metrics;
+  histogram.AppendTo("io", &metrics);
+  ASSERT_EQ(5, metrics.size());
+  EXPECT_EQ("io.count", metrics[0].first);
+  EXPECT_EQ(102, metrics[0].second);
+  EXPECT_EQ("io.p50_us", metrics[2].first);
+  EXPECT_EQ(1, metrics[2].second);
+}
+
+}  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_seq_scan_executor_test.cpp
+//
+// Identification: test/execution/parallel_seq_scan_executor_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/parallel_seq_scan_executor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Run a scan to the end, returning the RIDs of the tuples it produced. */
+static auto RunScan(AbstractExecutor *executor) -> std::vector<RID> {
+  std::vector<RID> rids;
+  Tuple tuple;
+  RID rid;
+  while (executor->Next(&tuple, &rid)) {
+    EXPECT_EQ(rid, tuple.GetRid());
+    rids.push_back(rid);
+  }
+  return rids;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelSeqScanExecutorTest, SampleTest) {
+  auto db = std::make_unique<BustubInstance>();
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}});
+  auto table_info = db->catalog_->CreateTable(nullptr, "t", schema);
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::vector<RID> rids;
+  for (int i = 0; i < 5000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(24, 'x'))};
+    rids.push_back(*table_info->table_->InsertTuple(meta, Tuple{values, &schema}));
+  }
+  for (int i = 0; i < 5000; i += 7) {
+    table_info->table_->UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  ASSERT_GE(table_info->table_->GetNumPages(), 16);
+
+  auto predicate = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER),
+      std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(4000)), ComparisonType::LessThan);
+  SeqScanPlanNode plan(std::make_shared<Schema>(schema), table_info->oid_, "t", predicate);
+  std::vector<RID> expected;
+  for (int i = 0; i < 4000; i++) {
+    if (i % 7 != 0) {
+      expected.push_back(rids[i]);
+    }
+  }
+
+  // Scenario: the tuples come out in the same order as from a scan on one thread.
+  {
+    ExecutorContext exec_ctx(nullptr, db->catalog_, db->buffer_pool_manager_, db->txn_manager_, db->lock_manager_,
+                             false);
+    SeqScanExecutor serial(&exec_ctx, &plan);
+    serial.Init();
+    EXPECT_EQ(expected, RunScan(&serial));
+    ParallelSeqScanExecutor parallel(&exec_ctx, &plan, 4);
+    parallel.Init();
+    EXPECT_EQ(expected, RunScan(&parallel));
+
+    // Scenario: a scan stopped early can be started over.
+    Tuple tuple;
+    RID rid;
+    parallel.Init();
+    ASSERT_TRUE(parallel.Next(&tuple, &rid));
+    EXPECT_EQ(expected[0], rid);
+    parallel.Init();
+    EXPECT_EQ(expected, RunScan(&parallel));
+
+    // Scenario: a scan run to the end is run again, e.g. as the inner side of a nested loop join.
+    for (int i = 0; i < 3; i++) {
+      parallel.Init();
+      EXPECT_EQ(expected, RunScan(&parallel));
+    }
+  }
+
+  // Scenario: a repeatable read scan locks every row it reads, like a scan on one thread.
+  {
+    auto txn = db->txn_manager_->Begin(nullptr, IsolationLevel::REPEATABLE_READ);
+    ExecutorContext exec_ctx(txn, db->catalog_, db->buffer_pool_manager_, db->txn_manager_, db->lock_manager_, false);
+    ParallelSeqScanExecutor parallel(&exec_ctx, &plan, 4);
+    parallel.Init();
+    EXPECT_EQ(expected, RunScan(&parallel));
+    EXPECT_TRUE(txn->IsTableIntentionSharedLocked(table_info->oid_));
+    EXPECT_EQ(rids.size(), (*txn->GetSharedRowLockSet())[table_info->oid_].size());
+    db->txn_manager_->Commit(txn);
+    delete txn;
+  }
+
+  // Scenario: a read committed scan lets go of its locks once it is done.
+  {
+    auto txn = db->txn_manager_->Begin(nullptr, IsolationLevel::READ_COMMITTED);
+    ExecutorContext exec_ctx(txn, db->catalog_, db->buffer_pool_manager_, db->txn_manager_, db->lock_manager_, false);
+    ParallelSeqScanExecutor parallel(&exec_ctx, &plan, 4);
+    parallel.Init();
+    EXPECT_EQ(expected, RunScan(&parallel));
+    EXPECT_FALSE(txn->IsTableIntentionSharedLocked(table_info->oid_));
+    EXPECT_TRUE((*txn->GetSharedRowLockSet())[table_info->oid_].empty());
+    db->txn_manager_->Commit(txn);
+    delete txn;
+  }
+}
+
+}  // namespace bustub
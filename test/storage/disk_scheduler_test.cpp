@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+/** Counts the vectored writes that reach the disk manager. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data) override {
+    num_vectored_writes_++;
+    DiskManagerUnlimitedMemory::WritePages(first_page_id, pages_data);
+  }
+
+  std::atomic<int> num_vectored_writes_{0};
+};
+
+/** Fails every read and write that touches one page. */
+class FailingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit FailingDiskManager(page_id_t failing_page_id) : failing_page_id_(failing_page_id) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == failing_page_id_) {
+      throw Exception("injected read error");
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    if (page_id == failing_page_id_) {
+      throw Exception("injected write error");
+    }
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages_data) override {
+    if (failing_page_id_ >= first_page_id &&
+        failing_page_id_ < first_page_id + static_cast<page_id_t>(pages_data.size())) {
+      throw Exception("injected write error");
+    }
+    DiskManagerUnlimitedMemory::WritePages(first_page_id, pages_data);
+  }
+
+ private:
+  page_id_t failing_page_id_;
+};
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  // The read is scheduled right behind the write of the same page and must observe it.
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+
+  ASSERT_TRUE(future1.get());
+  ASSERT_TRUE(future2.get());
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, MergeAdjacentWritesTest) {
+  const size_t num_pages = 48;
+  auto dm = std::make_unique<CountingDiskManager>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), 1);
+
+  // Scheduled in descending page order, written as one ascending run.
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (size_t i = num_pages; i-- > 0;) {
+    snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    requests.push_back({true, pages[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  disk_scheduler->Schedule(std::move(requests));
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  EXPECT_EQ(1, dm->num_vectored_writes_);
+
+  // Many readers, each one in flight on its own.
+  std::vector<std::vector<char>> read_pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  futures.clear();
+  for (size_t i = 0; i < num_pages; i++) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    disk_scheduler->Schedule({false, read_pages[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  for (size_t i = 0; i < num_pages; i++) {
+    EXPECT_EQ(0, std::memcmp(pages[i].data(), read_pages[i].data(), BUSTUB_PAGE_SIZE));
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, SamePageOrderTest) {
+  const size_t num_rounds = 100;
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), 4);
+
+  // Alternate writes and reads of a handful of pages: every read sees the write scheduled just before it.
+  std::vector<std::vector<char>> data(num_rounds, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::vector<char>> bufs(num_rounds, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < num_rounds; i++) {
+    auto page_id = static_cast<page_id_t>(i % 4);
+    snprintf(data[i].data(), BUSTUB_PAGE_SIZE, "round %zu", i);
+    auto write_promise = disk_scheduler->CreatePromise();
+    auto read_promise = disk_scheduler->CreatePromise();
+    futures.push_back(write_promise.get_future());
+    futures.push_back(read_promise.get_future());
+    disk_scheduler->Schedule({true, data[i].data(), page_id, std::move(write_promise)});
+    disk_scheduler->Schedule({false, bufs[i].data(), page_id, std::move(read_promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  for (size_t i = 0; i < num_rounds; i++) {
+    EXPECT_EQ(0, std::memcmp(data[i].data(), bufs[i].data(), BUSTUB_PAGE_SIZE));
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, FailedRequestTest) {
+  const page_id_t num_pages = 8;
+  auto dm = std::make_unique<FailingDiskManager>(4);
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), 1);
+
+  // A failing request resolves to false and the worker goes on with the next ones.
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    requests.push_back({true, pages[i].data(), i, std::move(promise)});
+  }
+  disk_scheduler->Schedule(std::move(requests));
+  EXPECT_FALSE(futures[4].get());
+
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  for (page_id_t page_id : {4, 7}) {
+    auto promise = disk_scheduler->CreatePromise();
+    auto future = promise.get_future();
+    disk_scheduler->Schedule({false, buf, page_id, std::move(promise)});
+    EXPECT_EQ(page_id != 4, future.get());
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+}  // namespace bustub
@@ -10,9 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/disk/disk_manager_memory.h"
@@ -48,4 +50,66 @@ TEST(PageGuardTest, SampleTest) {
   disk_manager->ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST(PageGuardTest, OptimisticReadTest) {
+  const size_t buffer_pool_size = 5;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  bpm->UnpinPage(page_id_temp, false);
+
+  // Scenario: the guard pins the page without latching it, readers don't invalidate it but writers do.
+  {
+    auto guard = bpm->FetchPageOptimistic(page_id_temp);
+    EXPECT_EQ(page0->GetData(), guard.GetData());
+    EXPECT_EQ(1, page0->GetPinCount());
+    EXPECT_TRUE(guard.Validate());
+
+    bpm->FetchPageRead(page_id_temp).Drop();
+    EXPECT_TRUE(guard.Validate());
+
+    bpm->FetchPageWrite(page_id_temp).Drop();
+    EXPECT_FALSE(guard.Validate());
+  }
+  EXPECT_EQ(0, page0->GetPinCount());
+
+  // Scenario: a guard taken while a writer holds the page never validates, even once the writer is gone.
+  {
+    auto write_guard = bpm->FetchPageWrite(page_id_temp);
+    auto guard = bpm->FetchPageOptimistic(page_id_temp);
+    EXPECT_FALSE(guard.Validate());
+    write_guard.Drop();
+    EXPECT_FALSE(guard.Validate());
+  }
+
+  // Scenario: a read that validates never sees a half-done write.
+  std::atomic<bool> stop = false;
+  std::thread writer([&bpm, &stop, page_id = page_id_temp] {
+    for (int value = 0; !stop; ++value) {
+      auto guard = bpm->FetchPageWrite(page_id);
+      auto data = guard.AsMut<int>();
+      data[0] = value;
+      std::this_thread::yield();
+      data[1] = value;
+    }
+  });
+  for (size_t i = 0; i < 10000; ++i) {
+    auto guard = bpm->FetchPageOptimistic(page_id_temp);
+    auto data = guard.As<int>();
+    int first = data[0];
+    int second = data[1];
+    if (guard.Validate()) {
+      EXPECT_EQ(first, second);
+    }
+  }
+  stop = true;
+  writer.join();
+
+  disk_manager->ShutDown();
+}
+
 }  // namespace bustub
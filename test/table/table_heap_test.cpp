@@ -0,0 +1,443 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto MakeTuple(const Schema &schema, int32_t key, size_t length) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(key), ValueFactory::GetVarcharValue(std::string(length, 'x'))};
+  return Tuple{values, &schema};
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  FreeSpaceMap free_space_map;
+
+  // Scenario: the page that fits the tuple most tightly is taken, and only once.
+  free_space_map.Update(0, 1000);
+  free_space_map.Update(1, 200);
+  free_space_map.Update(2, 500);
+  free_space_map.Update(3, FreeSpaceMap::MIN_FREE_SPACE - 1);
+  EXPECT_EQ(3, free_space_map.GetNumPages());
+  EXPECT_EQ(1700, free_space_map.GetTotalFreeSpace());
+  EXPECT_EQ(2, free_space_map.Take(300));
+  EXPECT_EQ(0, free_space_map.Take(300));
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Take(300));
+
+  // Scenario: updates replace what was recorded for a page.
+  free_space_map.Update(1, 400);
+  EXPECT_EQ(1, free_space_map.GetNumPages());
+  EXPECT_EQ(400, free_space_map.GetTotalFreeSpace());
+  free_space_map.Remove(1);
+  EXPECT_EQ(0, free_space_map.GetNumPages());
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Take(FreeSpaceMap::MIN_FREE_SPACE));
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceReuseTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, BUSTUB_PAGE_SIZE}});
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+
+  // Three large tuples fill a page. The fourth goes to a new page, and the rest of the first page to the map.
+  auto large = MakeTuple(schema, 0, 1200);
+  std::vector<RID> rids;
+  for (int i = 0; i < 4; i++) {
+    rids.push_back(*table.InsertTuple(meta, large));
+  }
+  auto first_page_id = rids[0].GetPageId();
+  EXPECT_EQ(first_page_id, rids[2].GetPageId());
+  auto second_page_id = rids[3].GetPageId();
+  EXPECT_NE(first_page_id, second_page_id);
+  ASSERT_EQ(1, table.GetFreeSpaceMap().GetNumPages());
+  size_t first_page_free_space = bpm->FetchPageRead(first_page_id).As<TablePage>()->GetFreeSpace();
+  EXPECT_EQ(first_page_free_space, table.GetFreeSpaceMap().GetTotalFreeSpace());
+
+  // Scenario: small tuples fill the current page first.
+  auto small = MakeTuple(schema, 1, 16);
+  auto medium = MakeTuple(schema, 2, first_page_free_space - 64);
+  while (bpm->FetchPageRead(second_page_id).As<TablePage>()->GetFreeSpace() >= medium.GetLength()) {
+    EXPECT_EQ(second_page_id, table.InsertTuple(meta, small)->GetPageId());
+  }
+
+  // Scenario: a tuple that does not fit the current page goes to the page that was left with room for it.
+  auto rid = *table.InsertTuple(meta, medium);
+  EXPECT_EQ(first_page_id, rid.GetPageId());
+  EXPECT_EQ(1, table.GetFreeSpaceMap().GetNumPages());
+
+  // All the tuples are found by a scan, in page order.
+  size_t num_tuples = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    num_tuples++;
+  }
+  EXPECT_EQ(num_tuples, bpm->FetchPageRead(first_page_id).As<TablePage>()->GetNumTuples() +
+                            bpm->FetchPageRead(second_page_id).As<TablePage>()->GetNumTuples());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ReusedPageIdTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  Schema key_schema({Column{"a", TypeId::BIGINT}});
+  GenericComparator<8> comparator(&key_schema);
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page_id, bpm.get(), comparator, 3, 3);
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 200; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID{0, static_cast<uint32_t>(key)});
+  }
+
+  // The table comes after the pages of the index, which then frees them.
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  TableHeap table(bpm.get());
+  for (int64_t key = 0; key < 200; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+
+  // Scenario: the pages appended to the table reuse the ids of the freed pages, which are lower than the first one.
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::vector<RID> rids;
+  for (int i = 0; i < 500; i++) {
+    rids.push_back(*table.InsertTuple(meta, MakeTuple(schema, i, 100)));
+  }
+  ASSERT_TRUE(std::any_of(rids.begin(), rids.end(),
+                          [&](const RID &rid) { return rid.GetPageId() < table.GetFirstPageId(); }));
+
+  // Scenario: a scan follows the page chain whatever the page ids, up to the last tuple when the scan started.
+  std::vector<RID> scanned;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    scanned.push_back(iter.GetRID());
+    if (scanned.size() == 1) {
+      table.InsertTuple(meta, MakeTuple(schema, 500, 100));
+    }
+  }
+  EXPECT_EQ(rids, scanned);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BulkInsertTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  LockManager lock_mgr{};
+  TransactionManager txn_mgr{&lock_mgr};
+  const table_oid_t oid = 0;
+
+  for (int i = 0; i < 10; i++) {
+    table.InsertTuple(meta, MakeTuple(schema, i, 10));
+  }
+  auto scan_before = table.MakeIterator();
+
+  // Scenario: a batch goes to new pages after the existing ones, every tuple row locked.
+  auto *txn = txn_mgr.Begin();
+  ASSERT_TRUE(lock_mgr.LockTable(txn, LockManager::LockMode::INTENTION_EXCLUSIVE, oid));
+  std::vector<Tuple> tuples;
+  for (int i = 10; i < 1010; i++) {
+    tuples.push_back(MakeTuple(schema, i, 50));
+  }
+  auto rids = table.BulkInsertTuples(meta, tuples, &lock_mgr, txn, oid);
+  ASSERT_EQ(tuples.size(), rids.size());
+  EXPECT_EQ(tuples.size(), (*txn->GetExclusiveRowLockSet())[oid].size());
+  txn_mgr.Commit(txn);
+  delete txn;
+  for (size_t i = 0; i < rids.size(); i++) {
+    EXPECT_NE(table.GetFirstPageId(), rids[i].GetPageId());
+    EXPECT_EQ(static_cast<int32_t>(i + 10), table.GetTuple(rids[i]).second.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+
+  // Scenario: only what is left of the last new page is free, the others are full.
+  auto last_page_id = rids.back().GetPageId();
+  ASSERT_EQ(1, table.GetFreeSpaceMap().GetNumPages());
+  EXPECT_EQ(bpm->FetchPageRead(last_page_id).As<TablePage>()->GetFreeSpace(),
+            table.GetFreeSpaceMap().GetTotalFreeSpace());
+
+  // Scenario: a scan started before the batch does not see it, a new scan sees all tuples in insertion order.
+  size_t num_tuples = 0;
+  for (; !scan_before.IsEnd(); ++scan_before) {
+    num_tuples++;
+  }
+  EXPECT_EQ(10, num_tuples);
+  int32_t expected_key = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    EXPECT_EQ(expected_key++, iter.GetTuple().second.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(1010, expected_key);
+
+  // Scenario: rows are not locked one by one under an exclusive table lock.
+  txn = txn_mgr.Begin();
+  ASSERT_TRUE(lock_mgr.LockTable(txn, LockManager::LockMode::EXCLUSIVE, oid));
+  rids = table.BulkInsertTuples(meta, tuples, &lock_mgr, txn, oid);
+  EXPECT_EQ(tuples.size(), rids.size());
+  EXPECT_TRUE((*txn->GetExclusiveRowLockSet())[oid].empty());
+  txn_mgr.Commit(txn);
+  delete txn;
+
+  // Scenario: a batch that cannot be locked is not linked, and its pages are given back.
+  auto num_pages = table.GetNumPages();
+  auto num_disk_pages = disk_manager->GetNumPages();
+  txn = txn_mgr.Begin();
+  ASSERT_TRUE(lock_mgr.LockTable(txn, LockManager::LockMode::INTENTION_EXCLUSIVE, oid));
+  txn->SetState(TransactionState::SHRINKING);
+  EXPECT_THROW(table.BulkInsertTuples(meta, tuples, &lock_mgr, txn, oid), TransactionAbortException);
+  txn_mgr.Abort(txn);
+  delete txn;
+  EXPECT_EQ(num_pages, table.GetNumPages());
+  EXPECT_EQ(num_disk_pages, disk_manager->GetNumPages());
+  num_tuples = 0;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    num_tuples++;
+  }
+  EXPECT_EQ(2010, num_tuples);
+
+  // Scenario: without a transaction nothing is locked.
+  rids = table.BulkInsertTuples(meta, tuples, &lock_mgr, nullptr, oid);
+  EXPECT_EQ(tuples.size(), rids.size());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, VacuumTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  LockManager lock_mgr{};
+  TransactionManager txn_mgr{&lock_mgr};
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 200; i++) {
+    rids.push_back(*table.InsertTuple(meta, MakeTuple(schema, i, 50)));
+  }
+  auto insert_page_id = rids.back().GetPageId();
+
+  // Scenario: tuples deleted by a running transaction are kept.
+  auto *txn0 = txn_mgr.Begin();
+  auto *txn1 = txn_mgr.Begin();
+  for (int i = 0; i < 200; i += 2) {
+    table.UpdateTupleMeta({INVALID_TXN_ID, txn1->GetTransactionId(), true}, rids[i]);
+  }
+  txn_mgr.Commit(txn1);
+  EXPECT_EQ(txn0->GetTransactionId(), txn_mgr.GetOldestActiveTxnId());
+  auto stats = table.Vacuum(txn_mgr.GetOldestActiveTxnId());
+  EXPECT_EQ(0, stats.num_compacted_pages_);
+  EXPECT_EQ(0, stats.reclaimed_bytes_);
+  auto dead_bytes = stats.dead_bytes_;
+  EXPECT_GT(dead_bytes, 0);
+
+  // Scenario: once all older transactions are gone, the space is reclaimed and the other tuples stay where they were.
+  txn_mgr.Commit(txn0);
+  EXPECT_EQ(txn1->GetTransactionId() + 1, txn_mgr.GetOldestActiveTxnId());
+  stats = table.Vacuum(txn_mgr.GetOldestActiveTxnId());
+  EXPECT_EQ(stats.num_pages_, stats.num_compacted_pages_);
+  EXPECT_EQ(dead_bytes, stats.reclaimed_bytes_);
+  EXPECT_EQ(0, stats.dead_bytes_);
+  for (int i = 0; i < 200; i++) {
+    auto [tuple_meta, tuple] = table.GetTuple(rids[i]);
+    EXPECT_EQ(i % 2 == 0, tuple_meta.is_deleted_);
+    if (i % 2 == 1) {
+      EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+  delete txn0;
+  delete txn1;
+
+  // Scenario: nothing was deleted since, the table is not read again.
+  auto num_pages = stats.num_pages_;
+  stats = table.Vacuum(txn_mgr.GetOldestActiveTxnId());
+  EXPECT_EQ(0, stats.num_compacted_pages_);
+  EXPECT_EQ(num_pages, stats.num_pages_);
+
+  // Scenario: the reclaimed space is used by inserts that do not fit in the page being filled.
+  auto small = MakeTuple(schema, 1000, 10);
+  while (bpm->FetchPageRead(insert_page_id).As<TablePage>()->GetFreeSpace() >= 1024) {
+    EXPECT_EQ(insert_page_id, table.InsertTuple(meta, small)->GetPageId());
+  }
+  auto rid = *table.InsertTuple(meta, MakeTuple(schema, 1001, 1000));
+  EXPECT_NE(insert_page_id, rid.GetPageId());
+  EXPECT_TRUE(
+      std::any_of(rids.begin(), rids.end(), [&](const RID &old_rid) { return old_rid.GetPageId() == rid.GetPageId(); }));
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, TupleViewTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, BUSTUB_PAGE_SIZE}});
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  for (int i = 0; i < 200; i++) {
+    table.InsertTuple(meta, MakeTuple(schema, i, i % 50));
+  }
+  ComparisonExpression predicate(std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER),
+                                 std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(100)),
+                                 ComparisonType::LessThan);
+
+  std::vector<Tuple> tuples;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    tuples.push_back(iter.GetTuple().second);
+  }
+
+  // Scenario: views read the same values as copies, and are copied out on demand.
+  size_t num_views = 0;
+  size_t num_matches = 0;
+  auto check_view = [&](const TupleMeta &view_meta, const TupleView &view) {
+    EXPECT_FALSE(view_meta.is_deleted_);
+    const auto &tuple = tuples[num_views++];
+    EXPECT_EQ(tuple.GetRid(), view.GetRid());
+    for (uint32_t column_idx = 0; column_idx < 2; column_idx++) {
+      auto value = view.GetValue(&schema, column_idx);
+      EXPECT_EQ(CmpBool::CmpTrue, tuple.GetValue(&schema, column_idx).CompareEquals(value));
+    }
+
+    // Scenario: expressions evaluate the same on a view as on a copy.
+    auto value = predicate.EvaluateView(view, schema);
+    EXPECT_EQ(CmpBool::CmpTrue, predicate.Evaluate(&tuple, schema).CompareEquals(value));
+    num_matches += value.GetAs<bool>() ? 1 : 0;
+    return true;
+  };
+  std::vector<Tuple> copies;
+  for (auto iter = table.MakeIterator(); !iter.IsEnd();) {
+    iter.NextPage(check_view, &copies);
+  }
+  EXPECT_EQ(tuples.size(), num_views);
+  EXPECT_EQ(100, num_matches);
+  ASSERT_EQ(tuples.size(), copies.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    EXPECT_EQ(tuples[i].GetRid(), copies[i].GetRid());
+    ASSERT_EQ(tuples[i].GetLength(), copies[i].GetLength());
+    EXPECT_EQ(0, memcmp(tuples[i].GetData(), copies[i].GetData(), copies[i].GetLength()));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PageAtATimeScanTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, BUSTUB_PAGE_SIZE}});
+  TableHeap table(bpm.get());
+  TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
+  std::vector<RID> rids;
+  for (int i = 0; i < 500; i++) {
+    rids.push_back(*table.InsertTuple(meta, MakeTuple(schema, i, 40)));
+  }
+  for (int i = 0; i < 500; i += 5) {
+    table.UpdateTupleMeta({INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  auto keep_even = [&](const TupleMeta &tuple_meta, const TupleView &view) {
+    return !tuple_meta.is_deleted_ && view.GetValue(&schema, 0).GetAs<int32_t>() % 2 == 0;
+  };
+  auto get_scan_fetches = [&]() {
+    return bpm->GetHitCount(AccessType::Scan) + bpm->GetMissCount(AccessType::Scan);
+  };
+
+  // Scenario: the filter and the visibility check run in the page loop, with one fetch per page.
+  auto iter = table.MakeIterator();
+  auto fetches_before = get_scan_fetches();
+  std::vector<Tuple> batch;
+  size_t num_pages = 0;
+  while (!iter.IsEnd()) {
+    iter.NextPage(keep_even, &batch);
+    num_pages++;
+  }
+  EXPECT_EQ(num_pages, get_scan_fetches() - fetches_before);
+  std::set<page_id_t> page_ids;
+  for (const auto &rid : rids) {
+    page_ids.insert(rid.GetPageId());
+  }
+  EXPECT_EQ(page_ids.size(), num_pages);
+  ASSERT_EQ(200, batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    auto key = batch[i].GetValue(&schema, 0).GetAs<int32_t>();
+    EXPECT_TRUE(key % 2 == 0 && key % 5 != 0);
+    EXPECT_EQ(rids[key], batch[i].GetRid());
+  }
+
+  // Scenario: a scan limited to the tuples locked beforehand stays on the page for the rest.
+  auto limited = table.MakeIterator();
+  auto first_rids = limited.GetPageRIDs();
+  ASSERT_GT(first_rids.size(), 3);
+  EXPECT_EQ(rids[0], first_rids[0]);
+  batch.clear();
+  limited.NextPage([](const TupleMeta &, const TupleView &) { return true; }, &batch, 3);
+  EXPECT_EQ(3, batch.size());
+  EXPECT_EQ(first_rids[3], limited.GetRID());
+  EXPECT_EQ(first_rids.size() - 3, limited.GetPageRIDs().size());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  const int num_threads = 8;
+  const int num_tuples_per_thread = 1000;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  TableHeap table(bpm.get());
+
+  std::vector<std::vector<RID>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      for (int i = 0; i < num_tuples_per_thread; i++) {
+        auto tuple = MakeTuple(schema, tid * num_tuples_per_thread + i, i % 100);
+        auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+        ASSERT_TRUE(rid.has_value());
+        rids[tid].push_back(*rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every tuple is stored once, where its insert said it was.
+  std::set<int32_t> keys;
+  for (int tid = 0; tid < num_threads; tid++) {
+    for (int i = 0; i < num_tuples_per_thread; i++) {
+      auto [meta, tuple] = table.GetTuple(rids[tid][i]);
+      EXPECT_EQ(tid * num_tuples_per_thread + i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+  for (auto iter = table.MakeIterator(); !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    EXPECT_TRUE(keys.insert(tuple.GetValue(&schema, 0).GetAs<int32_t>()).second);
+  }
+  EXPECT_EQ(num_threads * num_tuples_per_thread, keys.size());
+}
+
+}  // namespace bustub
@@ -13,7 +13,8 @@
 #include "argparse/argparse.hpp"
 #include "binder/binder.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/frame_replacer.h"
+#include "buffer/read_ahead.h"
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -21,7 +22,13 @@
 #include "fmt/std.h"
 #include "storage/disk/disk_manager_memory.h"
 
+#include <sys/ioctl.h>
 #include <sys/time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
 
 auto ClockMs() -> uint64_t {
   struct timeval tm;
@@ -31,6 +38,8 @@ auto ClockMs() -> uint64_t {
 
 static const size_t BUSTUB_SCAN_THREAD = 8;
 static const size_t BUSTUB_GET_THREAD = 8;
+static const size_t BUSTUB_HOT_GET_THREAD = 4;
+static const size_t BUSTUB_HOT_PAGE_CNT = 8;
 static const size_t LRU_K_SIZE = 16;
 static const size_t BUSTUB_PAGE_CNT = 6400;
 static const size_t BUSTUB_BPM_SIZE = 64;
@@ -38,7 +47,9 @@ static const size_t BUSTUB_BPM_SIZE = 64;
 struct BpmTotalMetrics {
   uint64_t scan_cnt_{0};
   uint64_t get_cnt_{0};
+  uint64_t hot_get_cnt_{0};
   uint64_t start_time_{0};
+  uint64_t elapsed_ms_{1};
   std::mutex mutex_;
 
   void Begin() { start_time_ = ClockMs(); }
@@ -53,19 +64,71 @@ struct BpmTotalMetrics {
     get_cnt_ += get_cnt;
   }
 
-  void Report() {
-    auto now = ClockMs();
-    auto elsped = now - start_time_;
-    auto scan_per_sec = scan_cnt_ / static_cast<double>(elsped) * 1000;
-    auto get_per_sec = get_cnt_ / static_cast<double>(elsped) * 1000;
+  void ReportHotGet(uint64_t hot_get_cnt) {
+    std::unique_lock<std::mutex> l(mutex_);
+    hot_get_cnt_ += hot_get_cnt;
+  }
+
+  void End() { elapsed_ms_ = ClockMs() - start_time_; }
+
+  auto ScanPerSec() const -> double { return scan_cnt_ / static_cast<double>(elapsed_ms_) * 1000; }
+
+  auto GetPerSec() const -> double { return get_cnt_ / static_cast<double>(elapsed_ms_) * 1000; }
 
+  auto HotGetPerSec() const -> double { return hot_get_cnt_ / static_cast<double>(elapsed_ms_) * 1000; }
+
+  void Report() {
+    End();
     fmt::print("<<< BEGIN\n");
-    fmt::print("scan: {}\n", scan_per_sec);
-    fmt::print("get: {}\n", get_per_sec);
+    fmt::print("scan: {}\n", ScanPerSec());
+    fmt::print("get: {}\n", GetPerSec());
+    fmt::print("hot_get: {}\n", HotGetPerSec());
     fmt::print(">>> END\n");
   }
 };
 
+/**
+ * Counts the dTLB read misses of the calling thread and of the threads it starts afterwards, if the kernel and the
+ * CPU let us.
+ */
+class TlbMissCounter {
+ public:
+  TlbMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  ~TlbMissCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  /** @return the misses counted so far, -1 if they can't be counted */
+  auto Read() -> int64_t {
+    uint64_t count;
+    if (fd_ < 0 || read(fd_, &count, sizeof(count)) != sizeof(count)) {
+      return -1;
+    }
+    return static_cast<int64_t>(count);
+  }
+
+ private:
+  int fd_{-1};
+};
+
 struct BpmMetrics {
   uint64_t start_time_{0};
   uint64_t last_report_at_{0};
@@ -100,41 +163,47 @@ struct BpmMetrics {
   }
 };
 
-// NOLINTNEXTLINE
-auto main(int argc, char **argv) -> int {
+struct BpmBenchConfig {
+  uint64_t duration_ms_;
+  uint64_t latency_ms_;
+  size_t num_shards_;
+  bool bg_writer_;
+  bool scan_;
+  bustub::ReplacerPolicy replacer_policy_;
+  size_t bpm_size_;
+  bool huge_pages_;
+  bool read_ahead_;
+};
+
+struct BpmBenchResult {
+  double scan_per_sec_;
+  double get_per_sec_;
+  double hot_get_per_sec_;
+  double clean_eviction_ratio_;
+  double get_hit_ratio_;
+  /** dTLB read misses per 1000 page accesses, negative if they could not be counted. */
+  double dtlb_misses_per_k_;
+};
+
+auto RunBench(const BpmBenchConfig &config) -> BpmBenchResult {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
   using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
 
-  argparse::ArgumentParser program("bustub-bpm-bench");
-  program.add_argument("--duration").help("run bpm bench for n milliseconds");
-  program.add_argument("--latency").help("set disk latency to n milliseconds");
-
-  try {
-    program.parse_args(argc, argv);
-  } catch (const std::runtime_error &err) {
-    std::cerr << err.what() << std::endl;
-    std::cerr << program;
-    return 1;
-  }
-
-  uint64_t duration_ms = 30000;
-  if (program.present("--duration")) {
-    duration_ms = std::stoi(program.get("--duration"));
-  }
-
-  uint64_t latency_ms = 0;
-  if (program.present("--latency")) {
-    latency_ms = std::stoi(program.get("--latency"));
-  }
+  auto duration_ms = config.duration_ms_;
 
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  auto bpm = std::make_unique<BufferPoolManager>(config.bpm_size_, disk_manager.get(), LRU_K_SIZE, nullptr,
+                                                 config.num_shards_, config.replacer_policy_, config.huge_pages_);
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, shards={}, "
+             "bg_writer={}, scan={}, replacer={}, frames={}, read_ahead={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, config.latency_ms_, LRU_K_SIZE, config.bpm_size_, config.num_shards_,
+             config.bg_writer_, config.scan_, bustub::ReplacerPolicyToString(config.replacer_policy_),
+             bustub::FrameArena::BackingToString(bpm->GetFrameArenaBacking()), config.read_ahead_);
 
   for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
     page_id_t page_id;
@@ -149,24 +218,50 @@ auto main(int argc, char **argv) -> int {
     page_ids.push_back(page_id);
   }
 
+  // The hot set stays pinned for the whole run, so that every fetch of it is a buffer pool hit. Its throughput shows
+  // how much the misses of the other threads get in the way of hits.
+  std::vector<page_id_t> hot_page_ids;
+  for (size_t i = 0; i < BUSTUB_HOT_PAGE_CNT; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      throw std::runtime_error("new page failed");
+    }
+    page->GetData()[0] = 1;
+    hot_page_ids.push_back(page_id);
+  }
+
   // enable disk latency after creating all pages
-  disk_manager->SetLatency(latency_ms);
+  disk_manager->SetLatency(config.latency_ms_);
+  if (config.bg_writer_) {
+    bpm->StartBackgroundWriter();
+  }
+  auto clean_evictions_before = bpm->GetCleanEvictionCount();
+  auto dirty_evictions_before = bpm->GetDirtyEvictionCount();
+  auto get_hits_before = bpm->GetHitCount(AccessType::Get);
+  auto get_misses_before = bpm->GetMissCount(AccessType::Get);
+  auto scan_hits_before = bpm->GetHitCount(AccessType::Scan);
+  auto scan_misses_before = bpm->GetMissCount(AccessType::Scan);
 
   fmt::print(stderr, "[info] benchmark start\n");
 
   BpmTotalMetrics total_metrics;
+  TlbMissCounter tlb_misses;
+  auto tlb_misses_before = tlb_misses.Read();
   total_metrics.Begin();
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_SCAN_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &page_ids, &bpm, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; config.scan_ && thread_id < BUSTUB_SCAN_THREAD; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, &page_ids, &bpm, duration_ms, &total_metrics, &config] {
       BpmMetrics metrics(fmt::format("scan {:>2}", thread_id), duration_ms);
       metrics.Begin();
+      bustub::ReadAhead read_ahead(config.read_ahead_ ? bpm.get() : nullptr);
 
       size_t page_idx = BUSTUB_PAGE_CNT * thread_id / BUSTUB_SCAN_THREAD;
 
       while (!metrics.ShouldFinish()) {
+        read_ahead.OnPage(page_ids[page_idx], page_ids[(page_idx + 1) % BUSTUB_PAGE_CNT]);
         auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan);
         if (page == nullptr) {
           continue;
@@ -222,11 +317,208 @@ auto main(int argc, char **argv) -> int {
     }));
   }
 
+  for (size_t thread_id = 0; thread_id < BUSTUB_HOT_GET_THREAD; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, &hot_page_ids, &bpm, duration_ms, &total_metrics] {
+      BpmMetrics metrics(fmt::format("hot  {:>2}", thread_id), duration_ms);
+      metrics.Begin();
+
+      size_t page_idx = thread_id;
+      while (!metrics.ShouldFinish()) {
+        // Not tagged as Get, so that these guaranteed hits don't count toward the get hit ratio.
+        auto *page = bpm->FetchPage(hot_page_ids[page_idx], AccessType::Unknown);
+        if (page == nullptr) {
+          throw std::runtime_error("hot page is not resident");
+        }
+
+        page->RLatch();
+        char ch = page->GetData()[0];
+        page->RUnlatch();
+        if (ch == 0) {
+          throw std::runtime_error("invalid data");
+        }
+
+        bpm->UnpinPage(page->GetPageId(), false, AccessType::Unknown);
+        page_idx = (page_idx + 1) % BUSTUB_HOT_PAGE_CNT;
+        metrics.Tick();
+        metrics.Report();
+      }
+
+      total_metrics.ReportHotGet(metrics.cnt_);
+    }));
+  }
+
   for (auto &thread : threads) {
     thread.join();
   }
 
   total_metrics.Report();
+  auto tlb_misses_after = tlb_misses.Read();
+  bpm->StopBackgroundWriter();
+
+  auto clean_evictions = bpm->GetCleanEvictionCount() - clean_evictions_before;
+  auto dirty_evictions = bpm->GetDirtyEvictionCount() - dirty_evictions_before;
+  auto clean_eviction_ratio =
+      clean_evictions + dirty_evictions > 0
+          ? static_cast<double>(clean_evictions) / static_cast<double>(clean_evictions + dirty_evictions)
+          : 0.0;
+  fmt::print(stderr, "[info] clean_evictions={}, dirty_evictions={}, background_writes={}\n", clean_evictions,
+             dirty_evictions, bpm->GetBackgroundWriteCount());
+
+  auto get_hits = bpm->GetHitCount(AccessType::Get) - get_hits_before;
+  auto get_misses = bpm->GetMissCount(AccessType::Get) - get_misses_before;
+  auto get_hit_ratio =
+      get_hits + get_misses > 0 ? static_cast<double>(get_hits) / static_cast<double>(get_hits + get_misses) : 0.0;
+  fmt::print(stderr, "[info] get_hits={}, get_misses={}\n", get_hits, get_misses);
+  fmt::print(stderr, "[info] scan_hits={}, scan_misses={}, prefetched={}\n",
+             bpm->GetHitCount(AccessType::Scan) - scan_hits_before,
+             bpm->GetMissCount(AccessType::Scan) - scan_misses_before, bpm->GetPrefetchCount());
+
+  auto accesses = total_metrics.scan_cnt_ + total_metrics.get_cnt_ + total_metrics.hot_get_cnt_;
+  double dtlb_misses_per_k = -1;
+  if (tlb_misses_before >= 0 && tlb_misses_after >= 0 && accesses > 0) {
+    dtlb_misses_per_k =
+        static_cast<double>(tlb_misses_after - tlb_misses_before) / static_cast<double>(accesses) * 1000;
+    fmt::print(stderr, "[info] dtlb_misses={}\n", tlb_misses_after - tlb_misses_before);
+  } else {
+    fmt::print(stderr, "[info] dtlb_misses=n/a\n");
+  }
+
+  for (auto page_id : hot_page_ids) {
+    bpm->UnpinPage(page_id, true);
+  }
+
+  return {total_metrics.ScanPerSec(), total_metrics.GetPerSec(), total_metrics.HotGetPerSec(), clean_eviction_ratio,
+          get_hit_ratio, dtlb_misses_per_k};
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-bpm-bench");
+  program.add_argument("--duration").help("run bpm bench for n milliseconds");
+  program.add_argument("--latency").help("comma-separated list of disk latencies in milliseconds to compare");
+  program.add_argument("--shards").help("comma-separated list of buffer pool shard counts to compare, e.g. 1,2,4,8");
+  program.add_argument("--bg-writer")
+      .help("compare runs without and with the background writer")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--scan-mix")
+      .help("compare the get hit ratio without and with scan threads running alongside")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--bpm-size").help("number of frames of the buffer pool");
+  program.add_argument("--huge-pages")
+      .help("compare runs with the frames on regular pages and on huge pages")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--replacer")
+      .help("comma-separated list of replacement policies to compare: lru_k, arc, 2q, clock_pro");
+  program.add_argument("--read-ahead")
+      .help("compare scan threads without and with read-ahead")
+      .default_value(false)
+      .implicit_value(true);
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 30000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+
+  std::vector<uint64_t> latencies{0};
+  if (program.present("--latency")) {
+    latencies.clear();
+    for (const auto &latency : bustub::StringUtil::Split(program.get("--latency"), ',')) {
+      latencies.push_back(std::stoul(latency));
+    }
+  }
+
+  std::vector<size_t> shard_counts{1};
+  if (program.present("--shards")) {
+    shard_counts.clear();
+    for (const auto &shards : bustub::StringUtil::Split(program.get("--shards"), ',')) {
+      shard_counts.push_back(std::stoul(shards));
+    }
+  }
+
+  std::vector<bool> bg_writer_modes{false};
+  if (program.get<bool>("--bg-writer")) {
+    bg_writer_modes.push_back(true);
+  }
+
+  std::vector<bool> scan_modes{true};
+  if (program.get<bool>("--scan-mix")) {
+    scan_modes.insert(scan_modes.begin(), false);
+  }
+
+  size_t bpm_size = BUSTUB_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoul(program.get("--bpm-size"));
+  }
+
+  std::vector<bool> huge_pages_modes{true};
+  if (program.get<bool>("--huge-pages")) {
+    huge_pages_modes.insert(huge_pages_modes.begin(), false);
+  }
+
+  std::vector<bool> read_ahead_modes{false};
+  if (program.get<bool>("--read-ahead")) {
+    read_ahead_modes.push_back(true);
+  }
+
+  std::vector<bustub::ReplacerPolicy> replacer_policies{bustub::ReplacerPolicy::LRUK};
+  if (program.present("--replacer")) {
+    replacer_policies.clear();
+    for (const auto &policy : bustub::StringUtil::Split(program.get("--replacer"), ',')) {
+      replacer_policies.push_back(bustub::ReplacerPolicyFromString(policy));
+    }
+  }
+
+  std::vector<BpmBenchConfig> configs;
+  std::vector<BpmBenchResult> results;
+  for (auto replacer_policy : replacer_policies) {
+    for (auto num_shards : shard_counts) {
+      for (auto latency_ms : latencies) {
+        for (auto bg_writer : bg_writer_modes) {
+          for (auto scan : scan_modes) {
+            for (auto huge_pages : huge_pages_modes) {
+              for (auto read_ahead : read_ahead_modes) {
+                configs.push_back({duration_ms, latency_ms, num_shards, bg_writer, scan, replacer_policy, bpm_size,
+                                   huge_pages, read_ahead});
+                results.push_back(RunBench(configs.back()));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (configs.size() > 1) {
+    fmt::print("<<< SCALING\n");
+    fmt::print("{:>10} {:>8} {:>10} {:>10} {:>6} {:>6} {:>6} {:>14} {:>14} {:>14} {:>12} {:>10} {:>10} {:>10}\n",
+               "replacer", "shards", "latency", "bg_writer", "scan", "huge", "ahead", "scan/s", "get/s", "hot_get/s",
+               "clean_evict", "get_hit", "dtlb/1k", "speedup");
+    auto base = results[0].scan_per_sec_ + results[0].get_per_sec_;
+    for (size_t i = 0; i < configs.size(); i++) {
+      auto total = results[i].scan_per_sec_ + results[i].get_per_sec_;
+      auto dtlb = results[i].dtlb_misses_per_k_ >= 0 ? fmt::format("{:.2f}", results[i].dtlb_misses_per_k_) : "n/a";
+      fmt::print(
+          "{:>10} {:>8} {:>10} {:>10} {:>6} {:>6} {:>6} {:>14.1f} {:>14.1f} {:>14.1f} {:>11.1f}% {:>9.1f}% {:>10} "
+          "{:>9.2f}x\n",
+          bustub::ReplacerPolicyToString(configs[i].replacer_policy_), configs[i].num_shards_, configs[i].latency_ms_,
+          configs[i].bg_writer_ ? "on" : "off", configs[i].scan_ ? "on" : "off", configs[i].huge_pages_ ? "on" : "off",
+          configs[i].read_ahead_ ? "on" : "off", results[i].scan_per_sec_, results[i].get_per_sec_, results[i].hot_get_per_sec_,
+          results[i].clean_eviction_ratio_ * 100, results[i].get_hit_ratio_ * 100, dtlb,
+          base > 0 ? total / base : 0.0);
+    }
+    fmt::print(">>> END\n");
+  }
 
   return 0;
 }
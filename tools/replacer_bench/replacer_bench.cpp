@@ -0,0 +1,248 @@
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/lru_k_replacer.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+using bustub::AccessType;
+using bustub::frame_id_t;
+
+/**
+ * The previous LRU-K replacer, kept as the baseline: a node per frame allocated on first access, a std::list of
+ * timestamps per node and a std::set of shared pointers ordered by k-distance. Same policy, scan handling included.
+ */
+class SetLRUKReplacer {
+ public:
+  SetLRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+
+  auto Evict(frame_id_t *frame_id) -> bool {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (evictable_frames_.empty()) {
+      return false;
+    }
+    *frame_id = (*evictable_frames_.begin())->fid_;
+    evictable_frames_.erase(evictable_frames_.begin());
+    auto &node = node_store_[*frame_id];
+    node->is_evictable_ = false;
+    node->history_.clear();
+    node->is_scan_only_ = false;
+    return true;
+  }
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) {
+    BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(replacer_size_), "Invalid frame_id");
+    std::lock_guard<std::mutex> lock(latch_);
+    if (node_store_.count(frame_id) == 0) {
+      node_store_[frame_id] = std::make_shared<Node>(frame_id);
+    } else if (node_store_[frame_id]->is_evictable_) {
+      evictable_frames_.erase(node_store_[frame_id]);
+    }
+
+    auto &node = node_store_[frame_id];
+    if (access_type == AccessType::Scan) {
+      if (node->history_.empty() || node->is_scan_only_) {
+        node->history_.clear();
+        node->is_scan_only_ = true;
+        AddHistoryEntry(node.get(), current_timestamp_++);
+      }
+    } else {
+      if (node->is_scan_only_) {
+        node->history_.clear();
+        node->is_scan_only_ = false;
+      }
+      AddHistoryEntry(node.get(), current_timestamp_++);
+    }
+    if (node->is_evictable_) {
+      evictable_frames_.insert(node);
+    }
+  }
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    BUSTUB_ENSURE(frame_id >= 0 && frame_id < static_cast<frame_id_t>(replacer_size_), "Invalid frame_id");
+    std::lock_guard<std::mutex> lock(latch_);
+    auto it = node_store_.find(frame_id);
+    if (it == node_store_.end()) {
+      return;
+    }
+    bool is_evictable = it->second->is_evictable_;
+    it->second->is_evictable_ = set_evictable;
+    if (is_evictable && !set_evictable) {
+      evictable_frames_.erase(it->second);
+    } else if (!is_evictable && set_evictable) {
+      evictable_frames_.insert(it->second);
+    }
+  }
+
+ private:
+  struct Node {
+    explicit Node(frame_id_t fid) : fid_(fid) {}
+    std::list<size_t> history_;
+    frame_id_t fid_;
+    bool is_evictable_{false};
+    bool is_scan_only_{false};
+  };
+
+  struct NodeLess {
+    auto operator()(const std::shared_ptr<Node> &left, const std::shared_ptr<Node> &right) const -> bool {
+      if (left->fid_ == right->fid_) {
+        return false;
+      }
+      if (left->is_scan_only_ || right->is_scan_only_) {
+        if (left->is_scan_only_ && right->is_scan_only_) {
+          return left->history_.front() < right->history_.front();
+        }
+        return left->is_scan_only_;
+      }
+      bool left_inf = left->history_.size() < k_;
+      bool right_inf = right->history_.size() < k_;
+      if (left_inf != right_inf) {
+        return left_inf;
+      }
+      return left->history_.front() < right->history_.front();
+    }
+    size_t k_;
+  };
+
+  void AddHistoryEntry(Node *node, size_t timestamp) const {
+    node->history_.push_back(timestamp);
+    if (node->history_.size() > k_) {
+      node->history_.pop_front();
+    }
+  }
+
+  size_t current_timestamp_{0};
+  size_t replacer_size_;
+  size_t k_;
+  std::set<std::shared_ptr<Node>, NodeLess> evictable_frames_{NodeLess{k_}};
+  std::unordered_map<frame_id_t, std::shared_ptr<Node>> node_store_;
+  std::mutex latch_;
+};
+
+struct ReplacerBenchConfig {
+  size_t num_frames_;
+  size_t num_pages_;
+  size_t num_ops_;
+  size_t k_;
+  /** Percentage of the accesses that belong to a sequential scan, the rest are zipfian gets. */
+  size_t scan_percent_;
+};
+
+struct ReplacerBenchResult {
+  double ops_per_sec_;
+  double hit_ratio_;
+};
+
+/**
+ * Drive a replacer the way the buffer pool does: every access of a resident page records an access and pins and
+ * unpins its frame, every access of a missing page evicts a frame first. Both replacers see the same trace, so they
+ * must end up with the same hit ratio.
+ */
+template <typename Replacer>
+auto RunTrace(const ReplacerBenchConfig &config) -> ReplacerBenchResult {
+  Replacer replacer(config.num_frames_, config.k_);
+  std::vector<frame_id_t> page_to_frame(config.num_pages_, -1);
+  std::vector<size_t> frame_to_page(config.num_frames_);
+  size_t free_frames = config.num_frames_;
+
+  std::default_random_engine gen(42);  // NOLINT
+  zipfian_int_distribution<size_t> get_dist(0, config.num_pages_ - 1, 0.8);
+  std::uniform_int_distribution<size_t> percent_dist(0, 99);
+  size_t scan_position = 0;
+  size_t hits = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t op = 0; op < config.num_ops_; op++) {
+    auto access_type = percent_dist(gen) < config.scan_percent_ ? AccessType::Scan : AccessType::Get;
+    size_t page;
+    if (access_type == AccessType::Scan) {
+      page = scan_position;
+      scan_position = (scan_position + 1) % config.num_pages_;
+    } else {
+      page = get_dist(gen);
+    }
+
+    auto frame_id = page_to_frame[page];
+    if (frame_id >= 0) {
+      hits++;
+    } else {
+      if (free_frames > 0) {
+        frame_id = static_cast<frame_id_t>(--free_frames);
+      } else {
+        if (!replacer.Evict(&frame_id)) {
+          throw bustub::Exception("no frame to evict");
+        }
+        page_to_frame[frame_to_page[frame_id]] = -1;
+      }
+      page_to_frame[page] = frame_id;
+      frame_to_page[frame_id] = page;
+    }
+    replacer.RecordAccess(frame_id, access_type);
+    replacer.SetEvictable(frame_id, false);
+    replacer.SetEvictable(frame_id, true);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return {static_cast<double>(config.num_ops_) / elapsed.count(),
+          static_cast<double>(hits) / static_cast<double>(config.num_ops_)};
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--frames").help("comma-separated list of replacer sizes to compare");
+  program.add_argument("--pages").help("number of distinct pages in the trace, as a multiple of the frames");
+  program.add_argument("--ops").help("number of accesses per run");
+  program.add_argument("--k").help("k of the LRU-K policy");
+  program.add_argument("--scan").help("percentage of the accesses that belong to a sequential scan");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  std::vector<size_t> frame_counts{64, 1024, 16384};
+  if (program.present("--frames")) {
+    frame_counts.clear();
+    for (const auto &frames : bustub::StringUtil::Split(program.get("--frames"), ',')) {
+      frame_counts.push_back(std::stoul(frames));
+    }
+  }
+  size_t page_factor = program.present("--pages") ? std::stoul(program.get("--pages")) : 8;
+  size_t num_ops = program.present("--ops") ? std::stoul(program.get("--ops")) : 2000000;
+  size_t k = program.present("--k") ? std::stoul(program.get("--k")) : 16;
+  size_t scan_percent = program.present("--scan") ? std::stoul(program.get("--scan")) : 20;
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("{:>8} {:>10} {:>6} {:>16} {:>16} {:>10} {:>10}\n", "frames", "pages", "k", "set ops/s", "array ops/s",
+             "hit_ratio", "speedup");
+  for (auto num_frames : frame_counts) {
+    ReplacerBenchConfig config{num_frames, num_frames * page_factor, num_ops, k, scan_percent};
+    auto baseline = RunTrace<SetLRUKReplacer>(config);
+    auto current = RunTrace<bustub::LRUKReplacer>(config);
+    if (baseline.hit_ratio_ != current.hit_ratio_) {
+      fmt::print(stderr, "[warn] hit ratios differ: set={} array={}\n", baseline.hit_ratio_, current.hit_ratio_);
+    }
+    fmt::print("{:>8} {:>10} {:>6} {:>16.0f} {:>16.0f} {:>9.1f}% {:>9.2f}x\n", num_frames, config.num_pages_, k,
+               baseline.ops_per_sec_, current.ops_per_sec_, current.hit_ratio_ * 100,
+               current.ops_per_sec_ / baseline.ops_per_sec_);
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}